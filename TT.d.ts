@@ -1,8 +1,35 @@
 declare module Module {
+    //replaced when the heap grows and views on the old buffer break, TTTranscoder.ts hands out views on reusable regions
     var HEAPU8:  Uint8Array;
+    var HEAP32:  Int32Array;
     function _malloc(size: number): number;
     function _free(ptr: number): void;
 
     function _TranscodeETC2_to_RGBA8(source: number, dest: number, width: number, height: number): void;
     function _TranscodeETC2_EAC_to_RGBA8(source: number, dest: number, width: number, height: number): void;
+    //COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+    function _TranscodeETC2_A1_to_RGBA8(source: number, dest: number, width: number, height: number): void;
+    //GL packed 16 bit pixels, dither 1 applies a 4x4 ordered dither
+    function _TranscodeETC2_to_RGB565(source: number, dest: number, width: number, height: number, dither: number): void;
+    function _TranscodeETC2_EAC_to_RGBA4444(source: number, dest: number, width: number, height: number, dither: number): void;
+    //rect is a pointer to a TTRect {x, y, width, height} of uint32, 0 for the whole image
+    function _TranscodeETC2_to_RGBA8_Rect(source: number, dest: number, width: number, height: number, destRowPitch: number, rect: number): void;
+    function _TranscodeETC2_EAC_to_RGBA8_Rect(source: number, dest: number, width: number, height: number, destRowPitch: number, rect: number): void;
+
+    //transform is a combination of SRGB_TO_LINEAR 1, LINEAR_TO_SRGB 2, PREMULTIPLY 4, BGRA 8 and FLIP_Y 16, destRowPitch 0 is width*4
+    function _TranscodeETC2_to_RGBA8_Transform(source: number, dest: number, width: number, height: number, destRowPitch: number, transform: number): void;
+    function _TranscodeETC2_EAC_to_RGBA8_Transform(source: number, dest: number, width: number, height: number, destRowPitch: number, transform: number): void;
+
+    //stats is a TTStats of 13 uint64: calls, etc2Blocks[5], eacBlocks, eacZeroMultiplierBlocks, bytesIn, bytesOut,
+    //nanoseconds, lastCallNanoseconds, maxCallNanoseconds. Returns 0 when built without -DTT_ENABLE_STATS=1
+    function _TTGetStats(stats: number): number;
+    function _TTResetStats(): void;
+
+    //threaded build (tt.mt.js) only: return at once and decode on the worker pool, threadCount 0 uses every worker.
+    //done points at a uint32 set to 1 once dest is complete, source and dest must not be freed before that.
+    function _TranscodeETC2_to_RGBA8_Async(source: number, dest: number, width: number, height: number, threadCount: number, done: number): void;
+    function _TranscodeETC2_EAC_to_RGBA8_Async(source: number, dest: number, width: number, height: number, threadCount: number, done: number): void;
+    //the same with the done flag managed by TTAsync.js, the promise resolves once dest is complete
+    function transcodeETC2_to_RGBA8(source: number, dest: number, width: number, height: number, threadCount?: number): Promise<void>;
+    function transcodeETC2_EAC_to_RGBA8(source: number, dest: number, width: number, height: number, threadCount?: number): Promise<void>;
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "BC.h"
+#include "BCBlock.h"
+#include "ETCKernel.h"
+namespace TT
+{
+	namespace Scalar
+	{
+		void DecodeBC1Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				((const BC1Block*)source)->Decode<true>(dest, destRowPitch);
+
+				source += 8;
+				dest += 16;
+			}
+		}
+
+		void DecodeBC3Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				((const BC1Block*)(source + 8))->Decode<false>(dest, destRowPitch);
+				((const BC3AlphaBlock*)source)->Decode(dest, destRowPitch);
+
+				source += 16;
+				dest += 16;
+			}
+		}
+	}
+
+	void TranscodeBC1_to_RGBA8(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TranscodeImageRows(GetKernels().decodeBC1Row, 8, source, dest, width, height);
+	}
+
+	void TranscodeBC3_to_RGB8A(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TranscodeImageRows(GetKernels().decodeBC3Row, 16, source, dest, width, height);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+#pragma once
+#include "BaseType.h"
+#include "Math.h"
+namespace TT
+{
+	//BC3 index of the 8 steps from alpha1 to alpha0
+	static const uint8 bc3StepToIndex[8] = { 1, 7, 6, 5, 4, 3, 2, 0 };
+
+	//4 color blocks the ETC2 transcoders write, both use the BC1Block layout
+	enum ColorBlockFormat
+	{
+		ColorBlockBC1,
+		ColorBlockATC,
+	};
+
+	//A pixel with t = (pixel - color1) . (color0 - color1) takes the step counting how many of thresholds[i] * length^2
+	//scale * t passes, the steps are the block colors from color1 to color0 at the midpoints between them
+	struct ColorBlockSteps
+	{
+		int32 scale;
+		int32 thresholds[3];
+		uint8 stepToIndex[4];
+	};
+
+	//BC1: color1, (color0 + 2 * color1) / 3, (2 * color0 + color1) / 3, color0
+	//ATC: color1, (3 * color0 + 5 * color1) / 8, (5 * color0 + 3 * color1) / 8, color0
+	static const ColorBlockSteps colorBlockSteps[2] =
+	{
+		{ 6, { 1, 3, 5 }, { 1, 3, 2, 0 } },
+		{ 16, { 3, 8, 13 }, { 3, 2, 1, 0 } },
+	};
+
+	inline uint32 PackRGB565(uint32 r, uint32 g, uint32 b)
+	{
+		return ((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255);
+	}
+
+	inline uint32 PackRGB555(uint32 r, uint32 g, uint32 b)
+	{
+		return ((r * 31 + 127) / 255) << 10 | ((g * 31 + 127) / 255) << 5 | ((b * 31 + 127) / 255);
+	}
+
+	//RGB565 to 0xAABBGGRR with bit replication
+	inline uint32 UnpackRGB565(uint32 color)
+	{
+		const uint32 r = extend_5to8bits((color >> 11) & 0x1F);
+		const uint32 g = extend_6to8bits((color >> 5) & 0x3F);
+		const uint32 b = extend_5to8bits(color & 0x1F);
+		return r | g << 8 | b << 16 | 0xFF000000;
+	}
+
+	inline uint32 UnpackRGB555(uint32 color)
+	{
+		const uint32 r = extend_5to8bits((color >> 10) & 0x1F);
+		const uint32 g = extend_5to8bits((color >> 5) & 0x1F);
+		const uint32 b = extend_5to8bits(color & 0x1F);
+		return r | g << 8 | b << 16 | 0xFF000000;
+	}
+
+	inline uint32 GetWidestChannel(const int32 extent[3])
+	{
+		return extent[0] >= extent[1] && extent[0] >= extent[2] ? 0 : (extent[1] >= extent[2] ? 1 : 2);
+	}
+
+	//Direction of the BC1 endpoint search: the bounding box extents, negated for the channels that fall while the widest
+	//channel rises (crossSums[c] = 16 * sum(widest * c) - sum(widest) * sum(c) over the 16 pixels), scaled so the largest is 31
+	inline void GetBC1Axis(const int32 extent[3], const int32 crossSums[3], int32 axis[3])
+	{
+		const int32 scale = (31 << 16) / extent[GetWidestChannel(extent)];
+		for (uint32 c = 0; c < 3; ++c)
+		{
+			const int32 length = (extent[c] * scale) >> 16;
+			axis[c] = crossSums[c] < 0 ? -length : length;
+		}
+	}
+
+	//BC1 color block, also the color half of BC2 and BC3
+	class BC1Block
+	{
+	public:
+		uint16 color0; //RGB565, color0 > color1 selects the 4 color mode
+		uint16 color1;
+		uint32 indices; //2 bits per pixel in row-major order, pixel (0, 0) in the low bits
+
+		//The 4 colors (0xAABBGGRR) the indices select. BC1 switches to 3 colors and transparent black when
+		//color0 <= color1, the color half of BC2 and BC3 always interpolates 4 colors.
+		template<bool isBC1>
+		void GetColors(uint32 colors[4]) const
+		{
+			colors[0] = UnpackRGB565(color0);
+			colors[1] = UnpackRGB565(color1);
+			colors[2] = colors[3] = 0xFF000000;
+			const bool fourColors = !isBC1 || color0 > color1;
+			for (uint32 c = 0; c < 24; c += 8)
+			{
+				const uint32 c0 = (colors[0] >> c) & 0xFF;
+				const uint32 c1 = (colors[1] >> c) & 0xFF;
+				if (fourColors)
+				{
+					colors[2] |= (2 * c0 + c1) / 3 << c;
+					colors[3] |= (c0 + 2 * c1) / 3 << c;
+				}
+				else
+					colors[2] |= (c0 + c1) / 2 << c;
+			}
+			if (!fourColors)
+				colors[3] = 0;
+		}
+
+		template<bool isBC1>
+		void Decode(uint8* dest, uint32 destRowPitch) const
+		{
+			uint32 colors[4];
+			GetColors<isBC1>(colors);
+			for (uint32 y = 0; y < 4; ++y)
+			{
+				uint32* row = (uint32*)(dest + y * destRowPitch);
+				for (uint32 x = 0; x < 4; ++x)
+					row[x] = colors[(indices >> ((y * 4 + x) * 2)) & 0x3];
+			}
+		}
+	};
+
+	//ATC_RGB_AMD block, color0 is RGB555 under the method bit (0 interpolates 4 colors) and color1 is RGB565.
+	//It is also the color half of ATC_RGBA_INTERPOLATED_ALPHA_AMD, whose alpha half is a BC3AlphaBlock.
+	typedef BC1Block ATCBlock;
+
+	//Quantize the endpoints high and low (0xAABBGGRR) into block and return the decoded color1 and color0 - color1 in
+	//start and direction. Returns false when every pixel takes the index already in block.indices.
+	template<uint32 format>
+	inline bool SetColorEndpoints(uint32 high, uint32 low, BC1Block& block, int32 start[3], int32 direction[3])
+	{
+		uint32 end0, end1;
+		if (format == ColorBlockBC1)
+		{
+			//the 4 color mode needs color0 > color1, the indices are picked after the swap
+			const uint32 packed0 = PackRGB565(high & 0xFF, (high >> 8) & 0xFF, (high >> 16) & 0xFF);
+			const uint32 packed1 = PackRGB565(low & 0xFF, (low >> 8) & 0xFF, (low >> 16) & 0xFF);
+			const uint32 color0 = Max(packed0, packed1);
+			const uint32 color1 = packed0 ^ packed1 ^ color0;
+
+			block.color0 = (uint16)color0;
+			block.color1 = (uint16)color1;
+			block.indices = 0;
+			if (color0 == color1)
+				return false;
+
+			end0 = UnpackRGB565(color0);
+			end1 = UnpackRGB565(color1);
+		}
+		else
+		{
+			block.color0 = (uint16)PackRGB555(high & 0xFF, (high >> 8) & 0xFF, (high >> 16) & 0xFF);
+			block.color1 = (uint16)PackRGB565(low & 0xFF, (low >> 8) & 0xFF, (low >> 16) & 0xFF);
+			block.indices = 0;
+			if (high == low)
+			{
+				//a single color keeps the extra green bit of color1
+				block.indices = 0xFFFFFFFF;
+				return false;
+			}
+
+			end0 = UnpackRGB555(block.color0);
+			end1 = UnpackRGB565(block.color1);
+		}
+
+		for (uint32 c = 0; c < 3; ++c)
+		{
+			start[c] = (end1 >> (c * 8)) & 0xFF;
+			direction[c] = (int32)((end0 >> (c * 8)) & 0xFF) - start[c];
+		}
+		return true;
+	}
+
+	//BC3 alpha block, alpha0 > alpha1 selects 8 interpolated values
+	class BC3AlphaBlock
+	{
+	public:
+		uint8 alpha0;
+		uint8 alpha1;
+		uint8 indices[6]; //3 bits per pixel in row-major order, little-endian
+
+		void SetIndices(uint64 indexBits)
+		{
+			for (uint32 i = 0; i < 6; ++i)
+				indices[i] = (uint8)(indexBits >> (i * 8));
+		}
+
+		uint64 GetIndexBits() const
+		{
+			uint64 indexBits = 0;
+			for (uint32 i = 0; i < 6; ++i)
+				indexBits |= (uint64)indices[i] << (i * 8);
+			return indexBits;
+		}
+
+		//alpha0 <= alpha1 interpolates 6 values and adds 0 and 255
+		void GetAlphas(uint8 alphas[8]) const
+		{
+			alphas[0] = alpha0;
+			alphas[1] = alpha1;
+			if (alpha0 > alpha1)
+			{
+				for (uint32 i = 2; i < 8; ++i)
+					alphas[i] = (uint8)(((8 - i) * alpha0 + (i - 1) * alpha1) / 7);
+			}
+			else
+			{
+				for (uint32 i = 2; i < 6; ++i)
+					alphas[i] = (uint8)(((6 - i) * alpha0 + (i - 1) * alpha1) / 5);
+				alphas[6] = 0;
+				alphas[7] = 255;
+			}
+		}
+
+		//Writes the alpha byte of each RGBA8 pixel
+		void Decode(uint8* dest, uint32 destRowPitch) const
+		{
+			uint8 alphas[8];
+			GetAlphas(alphas);
+			const uint64 indexBits = GetIndexBits();
+			for (uint32 y = 0; y < 4; ++y)
+			{
+				for (uint32 x = 0; x < 4; ++x)
+					dest[y * destRowPitch + x * 4 + 3] = alphas[(indexBits >> ((y * 4 + x) * 3)) & 0x7];
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "BC.h"
+#include "BCBlock.h"
+#include "ETCBlock.h"
+#include "ETCKernel.h"
+namespace TT
+{
+	//A BC1 block has at most 4 colors, so each subblock is fitted to the palette entries weighted by how many of its
+	//pixels use them instead of to the pixels. Both flips are fitted and the one with the smaller error is written.
+	//ETC1 has no alpha, transparent pixels get no weight and take selector 0 of their subblock.
+	static void EncodeETC1Block(const BC1Block& bc1, uint8* dest)
+	{
+		uint32 colors[4];
+		bc1.GetColors<true>(colors);
+		const bool hasTransparent = bc1.color0 <= bc1.color1;
+
+		//weights[flip][subblock][entry], subblock 1 is x >= 2 or, flipped, y >= 2
+		uint32 weights[2][2][4] = {};
+		uint8 entries[16];
+		for (uint32 y = 0; y < 4; ++y)
+		{
+			for (uint32 x = 0; x < 4; ++x)
+			{
+				const uint32 entry = (bc1.indices >> ((y * 4 + x) * 2)) & 0x3;
+				entries[x * 4 + y] = (uint8)entry;
+				if (hasTransparent && entry == 3)
+					continue;
+				++weights[0][x >> 1][entry];
+				++weights[1][y >> 1][entry];
+			}
+		}
+
+		ETC1SubblockFit fits[2][2];
+		int32 bases[2][2][3];
+		bool differential[2];
+		for (uint32 flip = 0; flip < 2; ++flip)
+		{
+			int32 mean1[3], mean2[3];
+			GetMeanColor(colors, weights[flip][0], 4, mean1);
+			GetMeanColor(colors, weights[flip][1], 4, mean2);
+
+			uint32 baseColor1, baseColor2;
+			differential[flip] = QuantizeETC1BaseColors(mean1, mean2, bases[flip][0], bases[flip][1], baseColor1, baseColor2);
+			FitETC1Subblock(baseColor1, colors, weights[flip][0], 4, fits[flip][0]);
+			FitETC1Subblock(baseColor2, colors, weights[flip][1], 4, fits[flip][1]);
+		}
+
+		const uint32 flip = (uint64)fits[1][0].error + fits[1][1].error < (uint64)fits[0][0].error + fits[0][1].error ? 1 : 0;
+		const uint32 subblockBits = flip ? 0xCCCC : 0xFF00;
+		uint8 selectors[16];
+		for (uint32 k = 0; k < 16; ++k)
+			selectors[k] = fits[flip][(subblockBits >> k) & 1].selectors[entries[k]];
+
+		WriteETC1Block(dest, differential[flip], flip != 0, bases[flip][0], bases[flip][1], fits[flip][0].table, fits[flip][1].table, selectors);
+	}
+
+	namespace Scalar
+	{
+		void TranscodeBC1ToETC1Blocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				EncodeETC1Block(*(const BC1Block*)source, dest);
+
+				source += 8;
+				dest += 8;
+			}
+		}
+	}
+
+	void TranscodeBC1_to_ETC1(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		GetKernels().transcodeBC1ToETC1Blocks(source, dest, ((width + 3) / 4) * ((height + 3) / 4));
+	}
+}
\ No newline at end of file
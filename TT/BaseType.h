@@ -8,6 +8,29 @@ namespace TT
 	#define TT_EXPORT 
 #endif
 
+//SSE4.1 kernels, built on every x86 target and used when cpuid reports SSE4.1 (see Dispatch.cpp)
+#if !defined(TT_SSE41)
+	#if (defined __x86_64__ || defined __i386__ || defined _M_X64 || defined _M_IX86) && !defined __EMSCRIPTEN__
+		#define TT_SSE41 1
+	#else
+		#define TT_SSE41 0
+	#endif
+#endif
+
+//wasm-simd128 decode kernels, enabled by emcc -msimd128
+#if !defined(TT_SIMD128)
+	#if defined __wasm_simd128__
+		#define TT_SIMD128 1
+	#else
+		#define TT_SIMD128 0
+	#endif
+#endif
+
+//Counters and timing behind TTGetStats, off by default so the transcoders carry no instrumentation (see Stats.h)
+#if !defined(TT_ENABLE_STATS)
+	#define TT_ENABLE_STATS 0
+#endif
+
 
 	typedef unsigned char       uint8;
 	typedef char		        int8;
@@ -16,11 +39,11 @@ namespace TT
 	typedef unsigned int        uint32;
 	typedef int                 int32;
 
-#ifdef __EMSCRIPTEN__
-	typedef unsigned long long	uint64;
-	typedef long long			int64;
-#else
+#ifdef _MSC_VER
 	typedef unsigned __int64	uint64;
 	typedef __int64				int64;
+#else
+	typedef unsigned long long	uint64;
+	typedef long long			int64;
 #endif
 }
\ No newline at end of file
@@ -47,12 +47,76 @@ namespace TT
 		static const ColorRGBA8 White;
 	};
 
+	//8 bit channel scaled to 0..maxValue, threshold 127 rounds to nearest and an ordered dither threshold (0..254) spreads the error
+	inline uint32 QuantizeChannel(uint32 value, uint32 maxValue, uint32 threshold)
+	{
+		const uint32 scaled = value * maxValue + threshold;
+		return (scaled + 1 + (scaled >> 8)) >> 8; //scaled / 255
+	}
+
+	//16 bit colors in the GL packed layouts, red in the top bits. PackRGB and PackAlpha are ORed together,
+	//so a block palette can be packed once and its alpha entries separately.
+
+	//GL_UNSIGNED_SHORT_4_4_4_4
 	class ColorRGBA4
 	{
-	};
+	public:
+		uint16 wColor;
+	public:
+		ColorRGBA4(uint32 rgba8 = 0xFFFFFFFF)
+			: wColor((uint16)(PackRGB(rgba8, 127) | PackAlpha(rgba8 >> 24)))
+		{}
 
+		static uint32 PackRGB(uint32 rgba8, uint32 threshold)
+		{
+			return QuantizeChannel(rgba8 & 0xFF, 15, threshold) << 12 | QuantizeChannel((rgba8 >> 8) & 0xFF, 15, threshold) << 8 | QuantizeChannel((rgba8 >> 16) & 0xFF, 15, threshold) << 4;
+		}
 
+		static uint32 PackAlpha(uint32 alpha)
+		{
+			return QuantizeChannel(alpha, 15, 127);
+		}
+	};
+
+	//GL_UNSIGNED_SHORT_5_6_5
 	class ColorRGB565
 	{
+	public:
+		uint16 wColor;
+	public:
+		ColorRGB565(uint32 rgba8 = 0xFFFFFFFF)
+			: wColor((uint16)PackRGB(rgba8, 127))
+		{}
+
+		static uint32 PackRGB(uint32 rgba8, uint32 threshold)
+		{
+			return QuantizeChannel(rgba8 & 0xFF, 31, threshold) << 11 | QuantizeChannel((rgba8 >> 8) & 0xFF, 63, threshold) << 5 | QuantizeChannel((rgba8 >> 16) & 0xFF, 31, threshold);
+		}
+
+		static uint32 PackAlpha(uint32)
+		{
+			return 0;
+		}
+	};
+
+	//GL_UNSIGNED_SHORT_5_5_5_1, alpha is set from 128 up
+	class ColorRGBA5551
+	{
+	public:
+		uint16 wColor;
+	public:
+		ColorRGBA5551(uint32 rgba8 = 0xFFFFFFFF)
+			: wColor((uint16)(PackRGB(rgba8, 127) | PackAlpha(rgba8 >> 24)))
+		{}
+
+		static uint32 PackRGB(uint32 rgba8, uint32 threshold)
+		{
+			return QuantizeChannel(rgba8 & 0xFF, 31, threshold) << 11 | QuantizeChannel((rgba8 >> 8) & 0xFF, 31, threshold) << 6 | QuantizeChannel((rgba8 >> 16) & 0xFF, 31, threshold) << 1;
+		}
+
+		static uint32 PackAlpha(uint32 alpha)
+		{
+			return alpha >> 7;
+		}
 	};
 }
\ No newline at end of file
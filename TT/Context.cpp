@@ -0,0 +1,75 @@
+#include <stdint.h>
+#include "Context.h"
+#include "ETCKernel.h"
+#include "Stream.h"
+namespace TT
+{
+	static uint32 GetRowPitch(uint32 width, uint32 destRowPitch)
+	{
+		return destRowPitch ? destRowPitch : width * 4;
+	}
+
+	TranscodeContext::TranscodeContext()
+		: m_outputSize(0)
+	{
+	}
+
+	size_t TranscodeContext::QueryOutputSize(TTFormat format, uint32 width, uint32 height, uint32 destRowPitch)
+	{
+		//a row and the whole buffer have to fit the uint32 pitch and size_t, 64-bit math so neither check wraps
+		const uint64 rowBytes = (uint64)width * 4;
+		if (!GetDecodeRow(format) || rowBytes > 0xFFFFFFFF || (destRowPitch && destRowPitch < rowBytes))
+			return 0;
+		const uint64 size = (uint64)GetRowPitch(width, destRowPitch) * height;
+		return size > (uint64)SIZE_MAX ? 0 : (size_t)size;
+	}
+
+	bool TranscodeContext::Reserve(TTFormat format, uint32 width, uint32 height, uint32 destRowPitch)
+	{
+		const size_t size = QueryOutputSize(format, width, height, destRowPitch);
+		if (size == 0)
+			return false;
+		//only grows, a smaller image keeps the larger buffer
+		if (size > m_output.size())
+			m_output.resize(size);
+		return true;
+	}
+
+	const uint8* TranscodeContext::Transcode(TTFormat format, const uint8* source, uint32 width, uint32 height, uint32 destRowPitch)
+	{
+		const DecodeRowFunc decodeRow = GetDecodeRow(format);
+		if (!decodeRow || !Reserve(format, width, height, destRowPitch))
+			return nullptr;
+
+		const uint32 rowPitch = GetRowPitch(width, destRowPitch);
+		TranscodeBlockRows(decodeRow, TTGetBlockSize(format), source, m_output.data(), rowPitch, width, height, 0, (height + 3) / 4);
+		m_outputSize = (size_t)rowPitch * height;
+		return m_output.data();
+	}
+
+	TranscodeContext* TTContextCreate()
+	{
+		return new TranscodeContext();
+	}
+
+	void TTContextDestroy(TranscodeContext* context)
+	{
+		delete context;
+	}
+
+	uint32 TTQueryOutputSize(TTFormat format, uint32 width, uint32 height, uint32 destRowPitch)
+	{
+		const size_t size = TranscodeContext::QueryOutputSize(format, width, height, destRowPitch);
+		return (uint64)size > 0xFFFFFFFF ? 0 : (uint32)size;
+	}
+
+	uint32 TTContextReserve(TranscodeContext* context, TTFormat format, uint32 width, uint32 height, uint32 destRowPitch)
+	{
+		return context->Reserve(format, width, height, destRowPitch) ? 1 : 0;
+	}
+
+	const uint8* TTContextTranscode(TranscodeContext* context, TTFormat format, const uint8* source, uint32 width, uint32 height, uint32 destRowPitch)
+	{
+		return context->Transcode(format, source, width, height, destRowPitch);
+	}
+}
\ No newline at end of file
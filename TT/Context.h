@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include "BaseType.h"
+#include "KTX.h"
+
+namespace TT
+{
+	//Owns the output buffer of RGBA8 transcodes so a caller decoding many images reuses one allocation.
+	//The decoders keep their scratch on the stack, a context touches no shared state once its buffer is large
+	//enough, so one context per thread transcodes concurrently. A context itself is not thread safe.
+	class TranscodeContext
+	{
+	public:
+		TranscodeContext();
+		TranscodeContext(const TranscodeContext&) = delete;
+		TranscodeContext& operator=(const TranscodeContext&) = delete;
+
+		//Bytes Transcode writes for a width x height image of format with rows destRowPitch bytes apart,
+		//0 means width * 4 as StreamTranscoder and the _Transform calls. The plain TranscodeETC2_*_to_RGBA8 calls
+		//pad rows to at least 16 bytes, so for widths below 4 this is not the size they write.
+		//0 when format can't be transcoded to RGBA8, destRowPitch is shorter than a row or the size overflows.
+		static size_t QueryOutputSize(TTFormat format, uint32 width, uint32 height, uint32 destRowPitch);
+
+		//Grows the output buffer to QueryOutputSize, later transcodes up to this size don't allocate
+		bool Reserve(TTFormat format, uint32 width, uint32 height, uint32 destRowPitch);
+
+		//Decodes source into the output buffer and returns it, nullptr when format is unsupported.
+		//The result stays valid until the next Transcode or Reserve that has to grow the buffer.
+		const uint8* Transcode(TTFormat format, const uint8* source, uint32 width, uint32 height, uint32 destRowPitch);
+
+		const uint8* GetOutput() const { return m_output.data(); }
+		size_t GetOutputSize() const { return m_outputSize; }
+		size_t GetCapacity() const { return m_output.size(); }
+
+	private:
+		std::vector<uint8> m_output;
+		size_t m_outputSize; //bytes of m_output written by the last Transcode
+	};
+
+	extern "C" {
+		TT_EXPORT TranscodeContext* TTContextCreate();
+		TT_EXPORT void TTContextDestroy(TranscodeContext* context);
+		TT_EXPORT uint32 TTQueryOutputSize(TTFormat format, uint32 width, uint32 height, uint32 destRowPitch); //0 as well when the size needs more than 32 bits
+		TT_EXPORT uint32 TTContextReserve(TranscodeContext* context, TTFormat format, uint32 width, uint32 height, uint32 destRowPitch); //1 when reserved, 0 when Reserve fails
+		TT_EXPORT const uint8* TTContextTranscode(TranscodeContext* context, TTFormat format, const uint8* source, uint32 width, uint32 height, uint32 destRowPitch);
+	}
+}
\ No newline at end of file
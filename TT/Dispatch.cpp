@@ -0,0 +1,144 @@
+#include "ETC.h"
+#include "ETCKernel.h"
+#include <atomic>
+#if TT_SSE41
+#if defined _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+namespace TT
+{
+	static const KernelTable scalarKernels =
+	{
+		TT_ISA_SCALAR,
+		Scalar::DecodeETC2Row,
+		Scalar::DecodeETC2A1Row,
+		Scalar::DecodeETC2EACRow,
+		Scalar::DecodeETC2ModeRun,
+		Scalar::decodeEACChannelRows,
+		Scalar::TranscodeETC2ToBC1Blocks,
+		Scalar::TranscodeETC2EACToBC3Blocks,
+		Scalar::TranscodeETC2ToATCBlocks,
+		Scalar::TranscodeETC2EACToATCBlocks,
+		Scalar::DecodeBC1Row,
+		Scalar::DecodeBC3Row,
+		Scalar::TranscodeBC1ToETC1Blocks,
+		Scalar::EncodeETC1FastRow,
+	};
+
+#if TT_SSE41
+	static const KernelTable sse41Kernels =
+	{
+		TT_ISA_SSE41,
+		SSE41::DecodeETC2Row,
+		SSE41::DecodeETC2A1Row,
+		SSE41::DecodeETC2EACRow,
+		SSE41::DecodeETC2ModeRun,
+		SSE41::decodeEACChannelRows,
+		SSE41::TranscodeETC2ToBC1Blocks,
+		SSE41::TranscodeETC2EACToBC3Blocks,
+		SSE41::TranscodeETC2ToATCBlocks,
+		SSE41::TranscodeETC2EACToATCBlocks,
+		SSE41::DecodeBC1Row,
+		SSE41::DecodeBC3Row,
+		SSE41::TranscodeBC1ToETC1Blocks,
+		SSE41::EncodeETC1FastRow,
+	};
+
+	//CPUID.1:ECX bit 19 is SSE4.1, bit 9 SSSE3 (pshufb, maddubs)
+	static bool HasSSE41()
+	{
+#if defined _MSC_VER
+		int info[4];
+		__cpuid(info, 1);
+		const uint32 ecx = (uint32)info[2];
+#else
+		unsigned int eax, ebx, ecx, edx;
+		if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+			return false;
+#endif
+		return (ecx & (1 << 19)) != 0 && (ecx & (1 << 9)) != 0;
+	}
+#endif
+
+#if TT_SIMD128
+	//wasm can't query features, a module built with -msimd128 only loads where SIMD128 is supported
+	static const KernelTable simd128Kernels =
+	{
+		TT_ISA_SIMD128,
+		SIMD128::DecodeETC2Row,
+		SIMD128::DecodeETC2A1Row,
+		SIMD128::DecodeETC2EACRow,
+		SIMD128::DecodeETC2ModeRun,
+		SIMD128::decodeEACChannelRows,
+		Scalar::TranscodeETC2ToBC1Blocks,
+		Scalar::TranscodeETC2EACToBC3Blocks,
+		Scalar::TranscodeETC2ToATCBlocks,
+		Scalar::TranscodeETC2EACToATCBlocks,
+		Scalar::DecodeBC1Row,
+		Scalar::DecodeBC3Row,
+		Scalar::TranscodeBC1ToETC1Blocks,
+		Scalar::EncodeETC1FastRow,
+	};
+#endif
+
+	//null when isa isn't built in or not supported
+	static const KernelTable* FindKernels(TTKernelISA isa)
+	{
+		switch (isa)
+		{
+		case TT_ISA_AUTO:
+#if TT_SIMD128
+			return &simd128Kernels;
+#else
+#if TT_SSE41
+			if (HasSSE41())
+				return &sse41Kernels;
+#endif
+			return &scalarKernels;
+#endif
+		case TT_ISA_SCALAR:
+			return &scalarKernels;
+#if TT_SSE41
+		case TT_ISA_SSE41:
+			return HasSSE41() ? &sse41Kernels : nullptr;
+#endif
+#if TT_SIMD128
+		case TT_ISA_SIMD128:
+			return &simd128Kernels;
+#endif
+		default:
+			return nullptr;
+		}
+	}
+
+	static std::atomic<const KernelTable*> currentKernels(nullptr);
+
+	const KernelTable& GetKernels()
+	{
+		const KernelTable* kernels = currentKernels.load(std::memory_order_acquire);
+		if (kernels == nullptr)
+		{
+			//first use, a TTSetKernelISA that got there first wins
+			const KernelTable* detected = FindKernels(TT_ISA_AUTO);
+			kernels = currentKernels.compare_exchange_strong(kernels, detected, std::memory_order_acq_rel) ? detected : kernels;
+		}
+		return *kernels;
+	}
+
+	uint32 TTSetKernelISA(TTKernelISA isa)
+	{
+		const KernelTable* kernels = FindKernels(isa);
+		if (kernels == nullptr)
+			return 0;
+		currentKernels.store(kernels, std::memory_order_release);
+		return 1;
+	}
+
+	TTKernelISA TTGetKernelISA()
+	{
+		return (TTKernelISA)GetKernels().isa;
+	}
+}
\ No newline at end of file
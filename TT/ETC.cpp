@@ -6,797 +6,772 @@
 // found in the LICENSE file.
 //
 
+#include <string.h>
 #include "ETC.h"
-#include "ColorBlock.h"
-#include "Math.h"
+#include "ETCBlock.h"
+#include "ETCKernel.h"
+#include "Stats.h"
 namespace TT
 {
-	// Table 3.17.2 sorted according to table 3.17.3
-	static const int32 intensityModifierDefault[8][4] =
-	{
-		{ 2,   8,  -2,   -8 },
-		{ 5,  17,  -5,  -17 },
-		{ 9,  29,  -9,  -29 },
-		{ 13,  42, -13,  -42 },
-		{ 18,  60, -18,  -60 },
-		{ 24,  80, -24,  -80 },
-		{ 33, 106, -33, -106 },
-		{ 47, 183, -47, -183 },
-	};
-
-	// Table C.12, intensity modifier for non opaque punchthrough alpha
-	static const int32 intensityModifierNonOpaque[8][4] =
-	{
-		{ 0,   8, 0,   -8 },
-		{ 0,  17, 0,  -17 },
-		{ 0,  29, 0,  -29 },
-		{ 0,  42, 0,  -42 },
-		{ 0,  60, 0,  -60 },
-		{ 0,  80, 0,  -80 },
-		{ 0, 106, 0, -106 },
-		{ 0, 183, 0, -183 },
-	};
-
-/*
-https://www.khronos.org/registry/OpenGL/extensions/OES/OES_compressed_ETC1_RGB8_texture.txt
-ETC1_RGB8_OES:
-
-a) bit layout in bits 63 through 32 if diffbit = 0
-
- 63 62 61 60 59 58 57 56 55 54 53 52 51 50 49 48
- -----------------------------------------------
-| base col1 | base col2 | base col1 | base col2 |
-| R1 (4bits)| R2 (4bits)| G1 (4bits)| G2 (4bits)|
- -----------------------------------------------
-
- 47 46 45 44 43 42 41 40 39 38 37 36 35 34  33  32
- ---------------------------------------------------
-| base col1 | base col2 | table  | table  |diff|flip|
-| B1 (4bits)| B2 (4bits)| cw 1   | cw 2   |bit |bit |
- ---------------------------------------------------
-
-
-b) bit layout in bits 63 through 32 if diffbit = 1
-
- 63 62 61 60 59 58 57 56 55 54 53 52 51 50 49 48
- -----------------------------------------------
-| base col1    | dcol 2 | base col1    | dcol 2 |
-| R1' (5 bits) | dR2    | G1' (5 bits) | dG2    |
- -----------------------------------------------
+	namespace Scalar
+	{
+		void DecodeETC2Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				const ETC2Block* pETC2Block = (ETC2Block*)source;
+				pETC2Block->Decode(dest, destRowPitch);
 
- 47 46 45 44 43 42 41 40 39 38 37 36 35 34  33  32
- ---------------------------------------------------
-| base col 1   | dcol 2 | table  | table  |diff|flip|
-| B1' (5 bits) | dB2    | cw 1   | cw 2   |bit |bit |
- ---------------------------------------------------
+				source += 8;
+				dest += 16;
+			}
+		}
 
+		void DecodeETC2A1Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				((const ETC2Block*)source)->DecodePunchThrough(dest, destRowPitch);
 
-c) bit layout in bits 31 through 0 (in both cases)
+				source += 8;
+				dest += 16;
+			}
+		}
 
- 31 30 29 28 27 26 25 24 23 22 21 20 19 18 17 16
- -----------------------------------------------
-|       most significant pixel index bits       |
-| p| o| n| m| l| k| j| i| h| g| f| e| d| c| b| a|
- -----------------------------------------------
+		void DecodeETC2EACRow(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				const ETC2Block* pETC2Block = (ETC2Block*)(source + 8);
+				pETC2Block->Decode(dest, destRowPitch);
 
- 15 14 13 12 11 10  9  8  7  6  5  4  3   2   1  0
- --------------------------------------------------
-|         least significant pixel index bits       |
-| p| o| n| m| l| k| j| i| h| g| f| e| d| c | b | a |
- --------------------------------------------------
-*/
-//https://www.khronos.org/registry/OpenGL/specs/es/3.0/es_spec_3.0.pdf page293
+				//ETC2Block.Decode will cover alpha channel with 255, so call EACBlock.Decode after ETC2Block.Decode
+				const EACBlock* pEACBlock = (EACBlock*)source;
+				pEACBlock->Decode(dest, destRowPitch);
 
-	class ETC2Block
-	{
-	private:
-		union {
-			// Individual, differential, H and T modes
-			struct
-			{
-				union {
-					// Individual and differential modes
-					struct
-					{
-						union {
-							struct  // Individual colors
-							{
-								uint8 R2 : 4;
-								uint8 R1 : 4;
-								uint8 G2 : 4;
-								uint8 G1 : 4;
-								uint8 B2 : 4;
-								uint8 B1 : 4;
-							} indiv;
-							struct  // Differential colors
-							{
-								int8 dR : 3;
-								uint8 R : 5;
-								int8 dG : 3;
-								uint8 G : 5;
-								int8 dB : 3;
-								uint8 B : 5;
-							} diff;
-						} colors;
-						bool flipbit : 1;
-						bool diffbit : 1;
-						uint8 cw2 : 3;
-						uint8 cw1 : 3;
-					} idm;
-					// T mode
-					struct
-					{
-						// Byte 1
-						uint8 TR1b : 2;
-						uint8 TdummyB : 1;
-						uint8 TR1a : 2;
-						uint8 TdummyA : 3;
-						// Byte 2
-						uint8 TB1 : 4;
-						uint8 TG1 : 4;
-						// Byte 3
-						uint8 TG2 : 4;
-						uint8 TR2 : 4;
-						// Byte 4
-						uint8 Tdb : 1;
-						bool Tflipbit : 1;
-						uint8 Tda : 2;
-						uint8 TB2 : 4;
-					} tm;
-					// H mode
-					struct
-					{
-						// Byte 1
-						uint8 HG1a : 3;
-						uint8 HR1 : 4;
-						uint8 HdummyA : 1;
-						// Byte 2
-						uint8 HB1b : 2;
-						uint8 HdummyC : 1;
-						uint8 HB1a : 1;
-						uint8 HG1b : 1;
-						uint8 HdummyB : 3;
-						// Byte 3
-						uint8 HG2a : 3;
-						uint8 HR2 : 4;
-						uint8 HB1c : 1;
-						// Byte 4
-						uint8 Hdb : 1;
-						bool Hflipbit : 1;
-						uint8 Hda : 1;
-						uint8 HB2 : 4;
-						uint8 HG2b : 1;
-					} hm;
-				} mode;
-				uint8 pixelIndexMSB[2];
-				uint8 pixelIndexLSB[2];
-			} idht;
-			// planar mode
-			struct
-			{
-				// Byte 1
-				uint8 GO1 : 1;
-				uint8 RO : 6;
-				uint8 PdummyA : 1;
-				// Byte 2
-				uint8 BO1 : 1;
-				uint8 GO2 : 6;
-				uint8 PdummyB : 1;
-				// Byte 3
-				uint8 BO3a : 2;
-				uint8 PdummyD : 1;
-				uint8 BO2 : 2;
-				uint8 PdummyC : 3;
-				// Byte 4
-				uint8 RH2 : 1;
-				bool Pflipbit : 1;
-				uint8 RH1 : 5;
-				uint8 BO3b : 1;
-				// Byte 5
-				uint8 BHa : 1;
-				uint8 GH : 7;
-				// Byte 6
-				uint8 RVa : 3;
-				uint8 BHb : 5;
-				// Byte 7
-				uint8 GVa : 5;
-				uint8 RVb : 3;
-				// Byte 8
-				uint8 BV : 6;
-				uint8 GVb : 2;
-			} pblk;
-			struct
-			{
-				uint32 part0;
-				uint32 part1;
-			};
-		} u;
+				source += 16;
+				dest += 16;
+			}
+		}
 
-	public:
-		void Decode1(uint8* dest, uint32 destRowPitch) const
+		template<uint32 mode, bool withAlpha>
+		static void DecodeModeRun(const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count)
 		{
-			// Select mode
-			//uint32 diff = (u.part0 >> 24) & 0x2;
-			//if (diff)
-			if(u.idht.mode.idm.diffbit)
+			for (uint32 i = 0; i < count; ++i)
 			{
-				//int32  R = (u.part0 >> 3) & 0x1F;
-				//int32 dR = ((u.part0 & 0x7) << 29) >> 29;
-				//int32  G = (u.part0 >> 11) & 0x1F;
-				//int32 dG = (((u.part0 >> 8) & 0x7) << 29) >> 29;
-				//int32  B = (u.part0 >> 19) & 0x1F;
-				//int32 dB = (((u.part0 >> 16) & 0x7) << 29) >> 29;
-				//int32 r = (R + dR);
-				//int32 g = (G + dG);
-				//int32 b = (B + dB);
-				const auto &diff = u.idht.mode.idm.colors.diff;
-				int r = (diff.R + diff.dR);
-				int g = (diff.G + diff.dG);
-				int b = (diff.B + diff.dB);
-
-				if (r < 0 || r > 31)
-				{
-					//DecodeTMode(dest, destRowPitch);
-				}
-				else if (g < 0 || g > 31)
-				{
-					//DecodeHMode(dest, destRowPitch);
-				}
-				else if (b < 0 || b > 31)
+				const uint8* block = source + blockIndices[i] * blockSize;
+				uint8* blockDest = dest + blockIndices[i] * 16;
+
+				const ETC2Block* pETC2Block = (ETC2Block*)(withAlpha ? block + 8 : block);
+				switch (mode)
 				{
-					//DecodePlanarMode(dest, destRowPitch);
+				case ETC2Block::ModeIndividual:
+					pETC2Block->DecodeIndividualMode(blockDest, destRowPitch);
+					break;
+				case ETC2Block::ModeDifferential:
+					pETC2Block->DecodeDifferentialMode(blockDest, destRowPitch);
+					break;
+				case ETC2Block::ModeT:
+					pETC2Block->DecodeTMode(blockDest, destRowPitch);
+					break;
+				case ETC2Block::ModeH:
+					pETC2Block->DecodeHMode(blockDest, destRowPitch);
+					break;
+				default:
+					pETC2Block->DecodePlanarMode(blockDest, destRowPitch);
+					break;
 				}
-				else
+
+				if (withAlpha)
 				{
-					DecodeDifferentialMode(dest, destRowPitch, diff.R, diff.G, diff.B, r, g, b);
+					const EACBlock* pEACBlock = (EACBlock*)block;
+					pEACBlock->Decode(blockDest, destRowPitch);
 				}
 			}
-			else
-			{
-				//DecodeIndividualMode(dest, destRowPitch);
-			}
 		}
 
-		void Decode(uint8* dest, uint32 destRowPitch) const
+		void DecodeETC2ModeRun(uint32 mode, const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count)
 		{
-			// Select mode
-			uint32 diff = (u.part0 >> 24) & 0x2;
-			if (diff)
+			typedef void (*RunFunc)(const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count);
+			static const RunFunc runs[2][5] =
 			{
-				int32  R = (u.part0 >> 3) & 0x1F;
-				int32 dR = ((int)(u.part0 & 0x7) << 29) >> 29;
-				int32  G = (u.part0 >> 11) & 0x1F;
-				int32 dG = ((int)((u.part0 >> 8) & 0x7) << 29) >> 29;
-				int32  B = (u.part0 >> 19) & 0x1F;
-				int32 dB = ((int)((u.part0 >> 16) & 0x7) << 29) >> 29;
-				int32 r = (R + dR);
-				int32 g = (G + dG);
-				int32 b = (B + dB);
-
-				if (r < 0 || r > 31)
 				{
-					DecodeTMode(dest, destRowPitch);
-				}
-				else if (g < 0 || g > 31)
+					DecodeModeRun<ETC2Block::ModeIndividual, false>, DecodeModeRun<ETC2Block::ModeDifferential, false>,
+					DecodeModeRun<ETC2Block::ModeT, false>, DecodeModeRun<ETC2Block::ModeH, false>, DecodeModeRun<ETC2Block::ModePlanar, false>,
+				},
 				{
-					DecodeHMode(dest, destRowPitch);
-				}
-				else if (b < 0 || b > 31)
-				{
-					DecodePlanarMode(dest, destRowPitch);
-				}
-				else
+					DecodeModeRun<ETC2Block::ModeIndividual, true>, DecodeModeRun<ETC2Block::ModeDifferential, true>,
+					DecodeModeRun<ETC2Block::ModeT, true>, DecodeModeRun<ETC2Block::ModeH, true>, DecodeModeRun<ETC2Block::ModePlanar, true>,
+				},
+			};
+			runs[blockSize == 16][mode](source, blockSize, dest, destRowPitch, blockIndices, count);
+		}
+
+		//R11 (channels = 1) and RG11 (channels = 2) into 16 or 8 bits per channel, the 11 bit value is
+		//bit-replicated to 16 bits and the 8 bit output keeps the high byte (rounded towards zero when signed)
+		template<bool isSigned, uint32 channels, bool is16Bits>
+		void DecodeEACChannelRow(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			const uint32 pixelSize = channels * (is16Bits ? 2 : 1);
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				for (uint32 c = 0; c < channels; ++c)
 				{
-					DecodeDifferentialMode(dest, destRowPitch, R, G, B, r, g, b);
+					int32 values[16];
+					((const EACBlock*)(source + c * 8))->DecodeChannel11<isSigned>(values);
+
+					for (uint32 j = 0; j < 4; j++)
+					{
+						uint8* row = dest + j * destRowPitch;
+						for (uint32 x = 0; x < 4; x++)
+						{
+							int32 value = values[j * 4 + x];
+							if (isSigned)
+								value = value >= 0 ? (value << 5) | (value >> 5) : -(((-value) << 5) | ((-value) >> 5));
+							else
+								value = (value << 5) | (value >> 6);
+
+							if (is16Bits)
+								*(uint16*)(row + x * pixelSize + c * 2) = (uint16)value;
+							else
+								row[x * pixelSize + c] = (uint8)(isSigned ? value / 256 : value >> 8);
+						}
+					}
 				}
-			}
-			else
-			{
-				DecodeIndividualMode(dest, destRowPitch);
+
+				source += channels * 8;
+				dest += pixelSize * 4;
 			}
 		}
 
-		void DecodeIndividualMode(uint8* dest, uint32 destRowPitch) const
+		const DecodeRowFunc decodeEACChannelRows[8] =
 		{
-			const auto &indiv = u.idht.mode.idm.colors.indiv;
-			int r1 = extend_4to8bits(indiv.R1);
-			int g1 = extend_4to8bits(indiv.G1);
-			int b1 = extend_4to8bits(indiv.B1);
-			int r2 = extend_4to8bits(indiv.R2);
-			int g2 = extend_4to8bits(indiv.G2);
-			int b2 = extend_4to8bits(indiv.B2);
-			DecodeIndividualOrDifferentialMode(dest, destRowPitch, r1, g1, b1, r2, g2, b2);
-		}
+			DecodeEACChannelRow<false, 1, false>, DecodeEACChannelRow<false, 1, true>, DecodeEACChannelRow<false, 2, false>, DecodeEACChannelRow<false, 2, true>,
+			DecodeEACChannelRow<true, 1, false>, DecodeEACChannelRow<true, 1, true>, DecodeEACChannelRow<true, 2, false>, DecodeEACChannelRow<true, 2, true>,
+		};
+	}
+
+	//Decode the pixels x, y, width x height of the image into dest, dest points at pixel (x, y) and rows are destRowPitch bytes apart
+	struct TranscodeJob
+	{
+		DecodeRowFunc decodeRow;
+		uint32 blockSize;
+		const uint8* source;
+		uint32 sourceBlockWidth;
+		uint8* dest;
+		uint32 x;
+		uint32 y;
+		uint32 width;
+		uint32 height;
+		uint32 destRowPitch;
+		uint32 pixelSize;
+		uint32 bandCount;
+	};
+
+	static TranscodeJob MakeTranscodeJob(DecodeRowFunc decodeRow, uint32 blockSize, const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 pixelSize = 4)
+	{
+		TranscodeJob job;
+		job.decodeRow = decodeRow;
+		job.blockSize = blockSize;
+		job.source = source;
+		job.sourceBlockWidth = (width + 3) / 4;
+		job.dest = dest;
+		job.x = 0;
+		job.y = 0;
+		job.width = width;
+		job.height = height;
+		job.destRowPitch = Max(width * pixelSize, pixelSize * 4);
+		job.pixelSize = pixelSize;
+		job.bandCount = 1;
+		return job;
+	}
+
+	//Restrict the job to rect clipped against the image, dest keeps addressing the top-left pixel of rect
+	static void SetTranscodeRect(TranscodeJob& job, const uint32 destRowPitch, const TTRect* rect)
+	{
+		job.destRowPitch = destRowPitch;
+		if (!rect)
+			return;
+
+		job.x = Min(rect->x, job.width);
+		job.y = Min(rect->y, job.height);
+		job.width = Min(rect->width, job.width - job.x);
+		job.height = Min(rect->height, job.height - job.y);
+	}
+
+	//block rows touched by the job rectangle
+	static inline uint32 FirstBlockRow(const TranscodeJob& job)
+	{
+		return job.y / 4;
+	}
+
+	static inline uint32 EndBlockRow(const TranscodeJob& job)
+	{
+		return job.width == 0 || job.height == 0 ? job.y / 4 : (job.y + job.height + 3) / 4;
+	}
+
+	//Decode one block into a scratch block and copy its columns x rows pixels starting at (left, top)
+	static void DecodeClippedBlock(DecodeRowFunc decodeRow, const uint8* source, uint8* dest, uint32 destRowPitch, uint32 pixelSize, uint32 left, uint32 top, uint32 columns, uint32 rows)
+	{
+		uint8 block[64];
+		decodeRow(source, block, pixelSize * 4, 1);
+		for (uint32 j = 0; j < rows; ++j)
+			memcpy(dest + j * destRowPitch, block + (top + j) * pixelSize * 4 + left * pixelSize, columns * pixelSize);
+	}
 
-		//void DecodeIndividualMode1(uint8* dest, uint32 destRowPitch) const
-		//{
-		//	int r1 = extend_4to8bits((u.part0 >> 4) & 0xF);
-		//	int r2 = extend_4to8bits(u.part0 & 0xF);
-		//	int g1 = extend_4to8bits((u.part0 >> 12) & 0xF);
-		//	int g2 = extend_4to8bits((u.part0 >> 8) & 0xF);
-		//	int b1 = extend_4to8bits((u.part0 >> 20) & 0xF);
-		//	int b2 = extend_4to8bits((u.part0 >> 16) & 0xF);
-		//	DecodeIndividualOrDifferentialMode(dest, destRowPitch, r1, g1, b1, r2, g2, b2);
-		//}
-
-		inline void DecodeDifferentialMode(uint8* dest, uint32 destRowPitch, int R, int G, int B, int r, int g, int b) const
+	//Decode blocks [bxBegin, bxEnd) of block row by one at a time, keeping only the pixels inside the job rectangle.
+	//source is the start of the block row and dest the row of the first pixel row written
+	static void TranscodeClippedBlocks(const TranscodeJob& job, const uint8* source, uint8* dest, uint32 by, uint32 bxBegin, uint32 bxEnd)
+	{
+		const uint32 top = Max(by * 4, job.y);
+		const uint32 bottom = Min(by * 4 + 4, job.y + job.height);
+		for (uint32 bx = bxBegin; bx < bxEnd; ++bx)
 		{
-			int r1 = extend_5to8bits(R);
-			int g1 = extend_5to8bits(G);
-			int b1 = extend_5to8bits(B);
-			int r2 = extend_5to8bits(r);
-			int g2 = extend_5to8bits(g);
-			int b2 = extend_5to8bits(b);
-			DecodeIndividualOrDifferentialMode(dest, destRowPitch, r1, g1, b1, r2, g2, b2);
+			const uint32 left = Max(bx * 4, job.x);
+			const uint32 right = Min(bx * 4 + 4, job.x + job.width);
+			DecodeClippedBlock(job.decodeRow, source + bx * job.blockSize, dest + (left - job.x) * job.pixelSize, job.destRowPitch, job.pixelSize,
+				left - bx * 4, top - by * 4, right - left, bottom - top);
 		}
+	}
 
-		//uint32 getIndex(uint32 x, uint32 y) const
-		//{
-		//	uint32 bitIndex = x * 4 + y;
-		//	uint32 bitOffset = bitIndex & 7;
-		//	uint32 lsb = (u.idht.pixelIndexLSB[1 - (bitIndex >> 3)] >> bitOffset) & 1;
-		//	uint32 msb = (u.idht.pixelIndexMSB[1 - (bitIndex >> 3)] >> bitOffset) & 1;
-		//	return (msb << 1) | lsb;
-		//}
-		inline uint32 getIndex(uint32 x, uint32 y) const
+	//Block columns of the job rectangle, blocks [fullBegin, fullEnd) are not cut by its left or right side
+	struct BlockColumns
+	{
+		uint32 begin;
+		uint32 fullBegin;
+		uint32 fullEnd;
+		uint32 end;
+	};
+
+	static BlockColumns GetBlockColumns(const TranscodeJob& job)
+	{
+		BlockColumns columns;
+		columns.begin = job.x / 4;
+		columns.end = (job.x + job.width + 3) / 4;
+		columns.fullBegin = Min((job.x + 3) / 4, columns.end);
+		columns.fullEnd = Max((job.x + job.width) / 4, columns.fullBegin);
+		return columns;
+	}
+
+	static void TranscodeRows(const TranscodeJob& job, uint32 byBegin, uint32 byEnd)
+	{
+		const BlockColumns columns = GetBlockColumns(job);
+
+		for (uint32 by = byBegin; by < byEnd; ++by)
 		{
-			uint32 bitIndex = x * 4 + y;
-			uint32 bitOffset = bitIndex & 7;
-#ifdef __EMSCRIPTEN__
-			uint32 lsb = ((u.part1 >> (16 + 8 * (1 - (bitIndex >> 3)))) >> bitOffset) & 0x1;
-			uint32 msb = ((u.part1 >> (8 * (1 - (bitIndex >> 3)))) >> bitOffset) & 0x1;
-			return (msb << 1) | lsb;
-#else
-			uint32 lsb = (u.idht.pixelIndexLSB[1 - (bitIndex >> 3)] >> bitOffset) & 1;
-			uint32 msb = (u.idht.pixelIndexMSB[1 - (bitIndex >> 3)] >> bitOffset) & 1;
-			return (msb << 1) | lsb;
-#endif
+			const uint8* source = job.source + by * job.sourceBlockWidth * job.blockSize;
+			const uint32 top = Max(by * 4, job.y);
+			uint8* dest = job.dest + (top - job.y) * job.destRowPitch;
+
+			//blocks cut by the rectangle are clipped so nothing is written outside it,
+			//a partial block would otherwise spill into the next pixel row or past the end of dest
+			if (by * 4 >= job.y && by * 4 + 4 <= job.y + job.height)
+				job.decodeRow(source + columns.fullBegin * job.blockSize, dest + (columns.fullBegin * 4 - job.x) * job.pixelSize, job.destRowPitch, columns.fullEnd - columns.fullBegin);
+			else
+				TranscodeClippedBlocks(job, source, dest, by, columns.fullBegin, columns.fullEnd);
+
+			TranscodeClippedBlocks(job, source, dest, by, columns.begin, columns.fullBegin);
+			TranscodeClippedBlocks(job, source, dest, by, columns.fullEnd, columns.end);
 		}
+	}
 
-		//void DecodeIndividualOrDifferentialMode1(uint8* dest, uint32 destRowPitch, int r1, int g1, int b1, int r2, int g2, int b2) const
-		//{
-		//	static ColorRGBA8 subblockColors0[4];
-		//	static ColorRGBA8 subblockColors1[4];
-		//	for (uint32 modifierIdx = 0; modifierIdx < 4; modifierIdx++)
-		//	{
-		//		const int32 i1 = intensityModifierDefault[u.idht.mode.idm.cw1][modifierIdx];
-		//		ColorRGBA8& c0 = subblockColors0[modifierIdx];
-		//		c0.r = ClampUint8(r1 + i1);
-		//		c0.g = ClampUint8(g1 + i1);
-		//		c0.b = ClampUint8(b1 + i1);
-
-		//		const int32 i2 = intensityModifierDefault[u.idht.mode.idm.cw2][modifierIdx];
-		//		ColorRGBA8& c1 = subblockColors1[modifierIdx];
-		//		c1.r = ClampUint8(r2 + i2);
-		//		c1.g = ClampUint8(g2 + i2);
-		//		c1.b = ClampUint8(b2 + i2);
-		//	}
-
-		//	if (u.idht.mode.idm.flipbit)
-		//	{
-		//		//Two 4x2-pixel subblocks on top of each other
-		//		for (uint32 j = 0; j < 2; j++)
-		//		{
-		//			for (uint32 i = 0; i < 4; i++)
-		//			{
-		//				uint32 index = j * destRowPitch + i * 4;
-		//				*(uint32*)(dest + index) = subblockColors0[getIndex(i, j)].dwColor;
-		//			}
-		//		}
-		//		for (uint32 j = 2; j < 4; j++)
-		//		{
-		//			for (uint32 i = 0; i < 4; i++)
-		//			{
-		//				uint32 index = j * destRowPitch + i * 4;
-		//				*(uint32*)(dest + index) = subblockColors0[getIndex(i, j)].dwColor;
-		//			}
-		//		}
-		//	}
-		//	else
-		//	{
-		//		//Two 2x4-pixel subblocks side-by-side
-		//		for (uint32 j = 0; j < 4; j++)
-		//		{
-		//			for (uint32 i = 0; i < 2; i++)
-		//			{
-		//				uint32 index = j * destRowPitch + i * 4;
-		//				*(uint32*)(dest + index) = subblockColors0[getIndex(i, j)].dwColor;
-		//			}
-		//		}
-		//		for (uint32 j = 0; j < 4; j++)
-		//		{
-		//			for (uint32 i = 2; i < 4; i++)
-		//			{
-		//				uint32 index = j * destRowPitch + i * 4;
-		//				*(uint32*)(dest + index) = subblockColors0[getIndex(i, j)].dwColor;
-		//			}
-		//		}
-		//	}
-		//}
-
-		void DecodeIndividualOrDifferentialMode(uint8* dest, uint32 destRowPitch, int r1, int g1, int b1, int r2, int g2, int b2) const
-		{
-			//ColorRGBA8 subblockColors0[4];
-			//ColorRGBA8 subblockColors1[4];
-			//const auto tableIdx1 = u.idht.mode.idm.cw1;
-			//const auto tableIdx2 = u.idht.mode.idm.cw2;
+	//Batched variant of TranscodeRows: the full blocks of a block row are first bucketed by ETC2 mode and
+	//then every bucket is decoded by one mode-specialized run, so the per-block mode branch is taken once per run
+	static void TranscodeRowsBatched(const TranscodeJob& job, uint32 byBegin, uint32 byEnd, TTETC2ModeCounts* modeCounts)
+	{
+		const uint32 chunkSize = 256;
+		uint16 buckets[TT_ETC2_MODE_COUNT][chunkSize];
+		uint32 counts[TT_ETC2_MODE_COUNT] = {};
 
-			uint32 subblockColors0[4];
-			uint32 subblockColors1[4];
-			uint32 tableIdx1 = (u.part0 >> 29) & 0x7;
-			uint32 tableIdx2 = (u.part0 >> 26) & 0x7;
+		const BlockColumns columns = GetBlockColumns(job);
+		const uint32 modeOffset = job.blockSize == 16 ? 8 : 0;
 
-			for (uint32 modifierIdx = 0; modifierIdx < 4; modifierIdx++)
-			{
-				const int32 i1 = intensityModifierDefault[tableIdx1][modifierIdx];
-				//ColorRGBA8& c0 = subblockColors0[modifierIdx];
-				//c0.r = ClampUint8(r1 + i1);
-				//c0.g = ClampUint8(g1 + i1);
-				//c0.b = ClampUint8(b1 + i1);
-				//c0.dwColor = ClampUint8(r1 + i1) | (ClampUint8(g1 + i1) << 8) | (ClampUint8(b1 + i1) << 16) | 0xFF000000;
-				subblockColors0[modifierIdx] = ClampUint8(r1 + i1) | (ClampUint8(g1 + i1) << 8) | (ClampUint8(b1 + i1) << 16) | 0xFF000000;
-
-				const int32 i2 = intensityModifierDefault[tableIdx2][modifierIdx];
-				//ColorRGBA8& c1 = subblockColors1[modifierIdx];
-				//c1.r = ClampUint8(r2 + i2);
-				//c1.g = ClampUint8(g2 + i2);
-				//c1.b = ClampUint8(b2 + i2);
-				//c1.dwColor = ClampUint8(r2 + i2) | (ClampUint8(g2 + i2) << 8) | (ClampUint8(b2 + i2) << 16) | 0xFF000000;
-				subblockColors1[modifierIdx] = ClampUint8(r2 + i2) | (ClampUint8(g2 + i2) << 8) | (ClampUint8(b2 + i2) << 16) | 0xFF000000;
-			}
+		for (uint32 by = byBegin; by < byEnd; ++by)
+		{
+			const uint8* source = job.source + by * job.sourceBlockWidth * job.blockSize;
+			const uint32 top = Max(by * 4, job.y);
+			uint8* dest = job.dest + (top - job.y) * job.destRowPitch;
+			const bool fullRow = by * 4 >= job.y && by * 4 + 4 <= job.y + job.height;
+			const uint32 batchedEnd = fullRow ? columns.fullEnd : columns.fullBegin;
 
-			uint32 flip = (u.part0 >> 24) & 0x1;
-			if (flip)
+			for (uint32 chunkBegin = columns.fullBegin; chunkBegin < batchedEnd; chunkBegin += chunkSize)
 			{
-				//Two 4x2-pixel subblocks on top of each other
-				for (uint32 j = 0; j < 2; j++)
+				const uint32 chunkEnd = Min(chunkBegin + chunkSize, batchedEnd);
+				uint32 runLength[TT_ETC2_MODE_COUNT] = {};
+				for (uint32 bx = chunkBegin; bx < chunkEnd; ++bx)
 				{
-					for (uint32 i = 0; i < 4; i++)
-					{
-						const uint32 destIndex = j * destRowPitch + i * 4;
-						*(uint32*)(dest + destIndex) = subblockColors0[getIndex(i, j)];
-					}
+					const uint32 mode = ((const ETC2Block*)(source + bx * job.blockSize + modeOffset))->GetMode();
+					buckets[mode][runLength[mode]++] = (uint16)(bx - chunkBegin);
 				}
-				for (uint32 j = 2; j < 4; j++)
+
+				const uint8* chunkSource = source + chunkBegin * job.blockSize;
+				uint8* chunkDest = dest + (chunkBegin * 4 - job.x) * job.pixelSize;
+				for (uint32 mode = 0; mode < TT_ETC2_MODE_COUNT; ++mode)
 				{
-					for (uint32 i = 0; i < 4; i++)
-					{
-						const uint32 destIndex = j * destRowPitch + i * 4;
-						*(uint32*)(dest + destIndex) = subblockColors1[getIndex(i, j)];
-					}
+					if (runLength[mode] == 0)
+						continue;
+					GetKernels().decodeETC2ModeRun(mode, chunkSource, job.blockSize, chunkDest, job.destRowPitch, buckets[mode], runLength[mode]);
+					counts[mode] += runLength[mode];
 				}
 			}
-			else
+
+			//partial blocks are rare, decode them one by one with the clipped path
+			TranscodeClippedBlocks(job, source, dest, by, batchedEnd, columns.fullEnd);
+			TranscodeClippedBlocks(job, source, dest, by, columns.begin, columns.fullBegin);
+			TranscodeClippedBlocks(job, source, dest, by, columns.fullEnd, columns.end);
+			for (uint32 bx = columns.begin; bx < columns.end; ++bx)
 			{
-				//Two 2x4-pixel subblocks side-by-side
-				for (uint32 j = 0; j < 4; j++)
-				{
-					for (uint32 i = 0; i < 2; i++)
-					{
-						const uint32 destIndex = j * destRowPitch + i * 4;
-						*(uint32*)(dest + destIndex) = subblockColors0[getIndex(i, j)];
-					}
-				}
-				for (uint32 j = 0; j < 4; j++)
-				{
-					for (uint32 i = 2; i < 4; i++)
-					{
-						const uint32 destIndex = j * destRowPitch + i * 4;
-						*(uint32*)(dest + destIndex) = subblockColors1[getIndex(i, j)];
-					}
-				}
+				if (bx < columns.fullBegin || bx >= batchedEnd)
+					++counts[((const ETC2Block*)(source + bx * job.blockSize + modeOffset))->GetMode()];
 			}
 		}
 
-		void DecodeTMode(uint8* dest, uint32 destRowPitch) const
+		if (modeCounts)
 		{
-			// Table C.8, distance index for T and H modes
-			const auto &tm = u.idht.mode.tm;
-
-			int r1 = extend_4to8bits(tm.TR1a << 2 | tm.TR1b);
-			int g1 = extend_4to8bits(tm.TG1);
-			int b1 = extend_4to8bits(tm.TB1);
-			int r2 = extend_4to8bits(tm.TR2);
-			int g2 = extend_4to8bits(tm.TG2);
-			int b2 = extend_4to8bits(tm.TB2);
-
-			static int distance[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
-			const int d = distance[tm.Tda << 1 | tm.Tdb];
-
-#ifdef __EMSCRIPTEN__
-			 uint32 paintColors[4] = {
-				r1 | g1<<8 | b1<<16 | 0xFF000000,
-				ClampUint8Right(r2 + d) | ClampUint8Right(g2 + d) << 8 | ClampUint8Right(b2 + d) << 16 | 0xFF000000,
-				r2 | g2 << 8 | b2 << 16 | 0xFF000000,
-				ClampUint8Left(r2 - d) | ClampUint8Left(g2 - d) << 8 | ClampUint8Left(b2 - d) << 16 | 0xFF000000,
-			};
+			for (uint32 mode = 0; mode < TT_ETC2_MODE_COUNT; ++mode)
+				modeCounts->blocks[mode] += counts[mode];
+		}
+	}
 
+	static inline bool SameBlock(const uint8* a, const uint8* b, uint32 blockSize)
+	{
+		uint64 a0, b0;
+		memcpy(&a0, a, 8);
+		memcpy(&b0, b, 8);
+		if (blockSize == 8 || a0 != b0)
+			return a0 == b0;
+		uint64 a1, b1;
+		memcpy(&a1, a + 8, 8);
+		memcpy(&b1, b + 8, 8);
+		return a1 == b1;
+	}
 
-			for (uint32 j = 0; j < 4; j++)
+	static inline uint64 HashBlock(const uint8* block, uint32 blockSize)
+	{
+		uint64 bits;
+		memcpy(&bits, block, 8);
+		if (blockSize == 16)
+		{
+			uint64 high;
+			memcpy(&high, block + 8, 8);
+			bits ^= high * 0xC2B2AE3D27D4EB4FULL;
+		}
+		return bits * 0x9E3779B97F4A7C15ULL;
+	}
+
+	//Cached variant of TranscodeRows: a full block with the same bytes as the block to its left, or as a recent block found
+	//in a small direct-mapped cache, is copied from where that block was decoded. The misses between hits are decoded as one run.
+	static void TranscodeRowsCached(const TranscodeJob& job, uint32 byBegin, uint32 byEnd, TTBlockCacheStats* stats)
+	{
+		const uint32 cacheBits = 8;
+		struct CacheEntry
+		{
+			const uint8* source;
+			uint8* dest;
+		};
+		CacheEntry cache[1 << cacheBits] = {};
+		uint32 blockCount = 0;
+		uint32 repeatHits = 0;
+		uint32 cacheHits = 0;
+
+		const BlockColumns columns = GetBlockColumns(job);
+		const uint32 blockRowSize = 4 * job.pixelSize;
+
+		for (uint32 by = byBegin; by < byEnd; ++by)
+		{
+			const uint8* source = job.source + by * job.sourceBlockWidth * job.blockSize;
+			const uint32 top = Max(by * 4, job.y);
+			uint8* dest = job.dest + (top - job.y) * job.destRowPitch;
+			const bool fullRow = by * 4 >= job.y && by * 4 + 4 <= job.y + job.height;
+			const uint32 cachedEnd = fullRow ? columns.fullEnd : columns.fullBegin;
+
+			uint32 runBegin = columns.fullBegin;
+			for (uint32 bx = columns.fullBegin; bx < cachedEnd; ++bx)
 			{
-				for (uint32 i = 0; i < 4; i++)
+				const uint8* block = source + bx * job.blockSize;
+				uint8* blockDest = dest + (bx * 4 - job.x) * job.pixelSize;
+				const uint8* matchDest;
+				if (bx > columns.fullBegin && SameBlock(block, block - job.blockSize, job.blockSize))
 				{
-					uint32 destIndex = j * destRowPitch + i * 4;
-					*(uint32*)(dest+ destIndex) = paintColors[getIndex(i, j)];
+					matchDest = blockDest - blockRowSize;
+					++repeatHits;
 				}
-			}
-#else
-			 ColorRGBA8 paintColors[4] = {
-				ColorRGBA8(r1, g1, b1, 255),
-				ColorRGBA8(ClampUint8Right(r2 + d), ClampUint8Right(g2 + d), ClampUint8Right(b2 + d), 255),
-				ColorRGBA8(r2, g2, b2, 255),
-				ColorRGBA8(ClampUint8Left(r2 - d), ClampUint8Left(g2 - d), ClampUint8Left(b2 - d), 255),
-			};
-
-			for (uint32 j = 0; j < 4; j++)
-			{
-				for (uint32 i = 0; i < 4; i++)
+				else
 				{
-					uint32 destIndex = j * destRowPitch + i * 4;
-					*(uint32*)(dest+ destIndex) = paintColors[getIndex(i, j)].dwColor;
+					CacheEntry& entry = cache[HashBlock(block, job.blockSize) >> (64 - cacheBits)];
+					if (entry.source == nullptr || !SameBlock(entry.source, block, job.blockSize))
+					{
+						entry.source = block;
+						entry.dest = blockDest;
+						continue;
+					}
+					matchDest = entry.dest;
+					++cacheHits;
 				}
+
+				//the match may be part of the pending run
+				if (runBegin < bx)
+					job.decodeRow(source + runBegin * job.blockSize, dest + (runBegin * 4 - job.x) * job.pixelSize, job.destRowPitch, bx - runBegin);
+				runBegin = bx + 1;
+				for (uint32 j = 0; j < 4; ++j)
+					memcpy(blockDest + j * job.destRowPitch, matchDest + j * job.destRowPitch, blockRowSize);
 			}
-#endif
+			if (runBegin < cachedEnd)
+				job.decodeRow(source + runBegin * job.blockSize, dest + (runBegin * 4 - job.x) * job.pixelSize, job.destRowPitch, cachedEnd - runBegin);
+
+			TranscodeClippedBlocks(job, source, dest, by, cachedEnd, columns.fullEnd);
+			TranscodeClippedBlocks(job, source, dest, by, columns.begin, columns.fullBegin);
+			TranscodeClippedBlocks(job, source, dest, by, columns.fullEnd, columns.end);
+			blockCount += columns.end - columns.begin;
 		}
 
-		void DecodeHMode(uint8* dest, uint32 destRowPitch) const
+		if (stats)
 		{
-			// Table C.8, distance index for T and H modes
-			const auto &hm = u.idht.mode.hm;
-
-			int r1 = extend_4to8bits(hm.HR1);
-			int g1 = extend_4to8bits(hm.HG1a << 1 | hm.HG1b);
-			int b1 = extend_4to8bits(hm.HB1a << 3 | hm.HB1b << 1 | hm.HB1c);
-			int r2 = extend_4to8bits(hm.HR2);
-			int g2 = extend_4to8bits(hm.HG2a << 1 | hm.HG2b);
-			int b2 = extend_4to8bits(hm.HB2);
-
-			static const int distance[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
-			const int orderingTrickBit =
-				((r1 << 16 | g1 << 8 | b1) >= (r2 << 16 | g2 << 8 | b2) ? 1 : 0);
-			const int d = distance[(hm.Hda << 2) | (hm.Hdb << 1) | orderingTrickBit];
-
-#ifdef __EMSCRIPTEN__
-			uint32 paintColors[4] = {
-				ClampUint8Right(r1 + d) | ClampUint8Right(g1 + d) << 8 | ClampUint8Right(b1 + d) << 16 | 0xFF000000,
-				ClampUint8Left(r1 - d) | ClampUint8Left(g1 - d) << 8 | ClampUint8Left(b1 - d) << 16 | 0xFF000000,
-				ClampUint8Right(r2 + d) | ClampUint8Right(g2 + d) << 8 | ClampUint8Right(b2 + d) << 16 | 0xFF000000,
-				ClampUint8Left(r2 - d) | ClampUint8Left(g2 - d) << 8 | ClampUint8Left(b2 - d) << 16 | 0xFF000000,
-			};
+			stats->blocks += blockCount;
+			stats->repeatHits += repeatHits;
+			stats->cacheHits += cacheHits;
+		}
+	}
 
-			for (uint32 j = 0; j < 4; j++)
-			{
-				for (uint32 i = 0; i < 4; i++)
-				{
-					uint32 destIndex = j * destRowPitch + i * 4;
-					*(uint32*)(dest + destIndex) = paintColors[getIndex(i, j)];
-				}
-			}
-#else
-			const ColorRGBA8 paintColors[4] = {
-				ColorRGBA8(ClampUint8Right(r1 + d), ClampUint8Right(g1 + d), ClampUint8Right(b1 + d), 255),
-				ColorRGBA8(ClampUint8Left(r1 - d), ClampUint8Left(g1 - d), ClampUint8Left(b1 - d), 255),
-				ColorRGBA8(ClampUint8Right(r2 + d), ClampUint8Right(g2 + d), ClampUint8Right(b2 + d), 255),
-				ColorRGBA8(ClampUint8Left(r2 - d), ClampUint8Left(g2 - d), ClampUint8Left(b2 - d), 255),
-			};
+	//Level n of a mip chain is Max(width >> n, 1) x Max(height >> n, 1) pixels
+	static inline uint32 GetMipSize(uint32 size, uint32 level)
+	{
+		return level < 32 ? Max(size >> level, 1u) : 1;
+	}
 
-			for (int j = 0; j < 4; j++)
-			{
-				for (int i = 0; i < 4; i++)
-				{
-					int index = j * destRowPitch + i * 4;
-					*(uint32*)(dest + index) = paintColors[getIndex(i, j)].dwColor;
-				}
-			}
+#if TT_ENABLE_STATS
+	static uint64 GetMipChainBytes(uint32 width, uint32 height, uint32 mipCount)
+	{
+		uint64 bytes = (uint64)width * height * 4;
+		for (uint32 level = 1; level <= mipCount && level <= 32; ++level)
+			bytes += (uint64)GetMipSize(width, level) * GetMipSize(height, level) * 4;
+		return bytes;
+	}
 #endif
+
+	//Rounded average of the 2x2 pixels above it for every RGBA8 pixel of dest. A pixel pair is loaded as one uint64 and
+	//the channels are summed two per 16 bit lane. An odd last column is dropped, a 1 pixel wide row averages its pixel with itself
+	static void DownsampleRow(const uint8* row0, const uint8* row1, const uint32 width, uint8* dest, const uint32 destWidth)
+	{
+		const uint64 mask = 0x00FF00FF00FF00FFull;
+		const uint32 pairCount = width / 2;
+		uint32* out = (uint32*)dest;
+		for (uint32 x = 0; x < pairCount; ++x)
+		{
+			uint64 top, bottom;
+			memcpy(&top, row0 + x * 8, 8);
+			memcpy(&bottom, row1 + x * 8, 8);
+			const uint64 rb = (top & mask) + (bottom & mask);
+			const uint64 ga = ((top >> 8) & mask) + ((bottom >> 8) & mask);
+			const uint32 rbSum = (uint32)rb + (uint32)(rb >> 32) + 0x00020002;
+			const uint32 gaSum = (uint32)ga + (uint32)(ga >> 32) + 0x00020002;
+			out[x] = ((rbSum >> 2) & 0x00FF00FF) | (((gaSum >> 2) & 0x00FF00FF) << 8);
 		}
 
-		void DecodePlanarMode(uint8* dest, uint32 destRowPitch) const
+		//a 1 pixel wide level
+		if (pairCount < destWidth)
 		{
-#ifdef __EMSCRIPTEN__
-			//need optimize
-			uint32 byte0 = u.part0 & 0xFF;
-			uint32 byte1 = (u.part0 >> 8) & 0xFF;
-			uint32 byte2 = (u.part0 >> 16) & 0xFF;
-			uint32 byte3 = (u.part0 >> 24) & 0xFF;
-			uint32 byte4 = u.part1 & 0xFF;
-			uint32 byte5 = (u.part1 >> 8) & 0xFF;
-			uint32 byte6 = (u.part1 >> 16) & 0xFF;
-			uint32 byte7 = (u.part1 >> 24) & 0xFF;
-			int ro = extend_6to8bits((byte0 >> 1) & 0x3F);
-			int gO1 = byte0 & 0x1;
-			int gO2 = (byte1 >> 1) & 0x3F;
-			int go = extend_7to8bits((gO1 << 6) | gO2);
-			int bO1 = byte1 & 0x1;
-			int bO2 = (byte2 >> 3) & 0x3;
-			int bO3 = ((byte2 & 0x3) << 1) | (byte3 >> 7);
-			int bo = extend_6to8bits(bO1 << 5 | bO2 << 3 | bO3);
-
-			int rH1 = (byte3 >> 2) & 0x1F;
-			int rH2 = byte3 & 0x1;
-			int rh = extend_6to8bits(rH1 << 1 | rH2);
-			int gh = extend_7to8bits(byte4 >> 1);
-			int bh = extend_6to8bits(((byte4 & 0x1) << 5) | (byte5 >> 3));
-
-			int rv = extend_6to8bits(((byte5 & 0x7) << 3) | (byte6 >> 5));
-			int gv = extend_7to8bits(((byte6 & 0x1F) << 2) | (byte7 >> 6));
-			int bv = extend_6to8bits(byte7 & 0x3F);
-#else
-			int ro = extend_6to8bits(u.pblk.RO);
-			int go = extend_7to8bits(u.pblk.GO1 << 6 | u.pblk.GO2);
-			int bo = extend_6to8bits(u.pblk.BO1 << 5 | u.pblk.BO2 << 3 | u.pblk.BO3a << 1 | u.pblk.BO3b);
-			int rh = extend_6to8bits(u.pblk.RH1 << 1 | u.pblk.RH2);
-			int gh = extend_7to8bits(u.pblk.GH);
-			int bh = extend_6to8bits(u.pblk.BHa << 5 | u.pblk.BHb);
-			int rv = extend_6to8bits(u.pblk.RVa << 3 | u.pblk.RVb);
-			int gv = extend_7to8bits(u.pblk.GVa << 2 | u.pblk.GVb);
-			int bv = extend_6to8bits(u.pblk.BV);
-#endif
+			const uint32 x0 = pairCount * 2;
+			const uint32 x1 = Min(x0 + 1, width - 1);
+			const uint32 p0 = ((const uint32*)row0)[x0], p1 = ((const uint32*)row0)[x1];
+			const uint32 p2 = ((const uint32*)row1)[x0], p3 = ((const uint32*)row1)[x1];
+			const uint32 rb = (p0 & 0x00FF00FF) + (p1 & 0x00FF00FF) + (p2 & 0x00FF00FF) + (p3 & 0x00FF00FF) + 0x00020002;
+			const uint32 ga = ((p0 >> 8) & 0x00FF00FF) + ((p1 >> 8) & 0x00FF00FF) + ((p2 >> 8) & 0x00FF00FF) + ((p3 >> 8) & 0x00FF00FF) + 0x00020002;
+			out[pairCount] = ((rb >> 2) & 0x00FF00FF) | (((ga >> 2) & 0x00FF00FF) << 8);
+		}
+	}
 
-			int rvo = rv - ro;
-			int gvo = gv - go;
-			int bvo = bv - bo;
+	//Mip variant of TranscodeRows: after every block row the rows of levels 1..mipCount that only depend on pixel rows
+	//decoded so far are built, so each level is made from rows of the level above while they are still in cache
+	static void TranscodeRowsMips(const TranscodeJob& job, uint8* const* mipDests, const uint32 mipCount)
+	{
+		const uint32 maxLevels = 32;
+		uint32 readyRows[maxLevels + 1] = {}; //pixel rows of each level written so far
+		const uint32 levelCount = Min(mipCount, maxLevels);
+		const uint32 bh = (job.height + 3) / 4;
 
-			int rho = rh - ro;
-			int gho = gh - go;
-			int bho = bh - bo;
+		for (uint32 by = 0; by < bh; ++by)
+		{
+			TranscodeRows(job, by, by + 1);
+			readyRows[0] = Min(by * 4 + 4, job.height);
 
-			for (int j = 0; j < 4; j++)
+			for (uint32 level = 1; level <= levelCount; ++level)
 			{
-				int ry = j * rvo + 2;
-				int gy = j * gvo + 2;
-				int by = j * bvo + 2;
-
-				for (int i = 0; i < 4; i++)
+				const uint32 srcWidth = GetMipSize(job.width, level - 1);
+				const uint32 srcHeight = GetMipSize(job.height, level - 1);
+				const uint32 srcPitch = level == 1 ? job.destRowPitch : srcWidth * 4;
+				const uint8* src = level == 1 ? job.dest : mipDests[level - 2];
+				const uint32 mipWidth = GetMipSize(job.width, level);
+				const uint32 mipHeight = GetMipSize(job.height, level);
+
+				uint32 y = readyRows[level];
+				while (y < mipHeight && Min(y * 2 + 1, srcHeight - 1) < readyRows[level - 1])
 				{
-					int destIndex = j * destRowPitch + i * 4;
-#ifdef __EMSCRIPTEN__
-					uint32 r = ClampUint8(((i*rho + ry) >> 2) + ro);
-					uint32 g = ClampUint8(((i*gho + gy) >> 2) + go);
-					uint32 b = ClampUint8(((i*bho + by) >> 2) + bo);
-					*(uint32*)(dest + destIndex) = r | (g << 8) | (b << 16) | 0xFF000000;
-#else
-					ColorRGBA8& color = *(ColorRGBA8*)(dest + destIndex);
-					//color.r = ClampUint8((i*(rh - ro) + j * (rv - ro) + 2) >> 2 + ro);
-					//color.g = ClampUint8((i*(gh - go) + j * (gv - go) + 2) >> 2 + ro);
-					//color.b = ClampUint8((i*(bh - bo) + j * (bv - ro) + 2) >> 2 + ro);
-					color.r = ClampUint8(((i*rho + ry) >> 2) + ro);
-					color.g = ClampUint8(((i*gho + gy) >> 2) + go);
-					color.b = ClampUint8(((i*bho + by) >> 2) + bo);
-					color.a = 255;
-#endif
+					DownsampleRow(src + y * 2 * srcPitch, src + Min(y * 2 + 1, srcHeight - 1) * srcPitch, srcWidth, mipDests[level - 1] + y * mipWidth * 4, mipWidth);
+					++y;
 				}
+				if (y == readyRows[level])
+					break; //the levels below wait for this one
+				readyRows[level] = y;
 			}
 		}
-	};
+	}
+
+	//Task i decodes the i-th band of block rows, bands are contiguous so every worker streams through its own part of source and dest
+	static void TranscodeBand(void* taskData, uint32 taskIndex)
+	{
+		const TranscodeJob& job = *(const TranscodeJob*)taskData;
+		const uint32 firstRow = FirstBlockRow(job);
+		const uint32 bh = EndBlockRow(job) - firstRow; //block height
+
+		uint32 byBegin = firstRow + (uint32)((uint64)bh * taskIndex / job.bandCount);
+		uint32 byEnd = firstRow + (uint32)((uint64)bh * (taskIndex + 1) / job.bandCount);
+		TranscodeRows(job, byBegin, byEnd);
+	}
+
+	static void TranscodeBands(TranscodeJob& job, uint32 threadCount)
+	{
+		ThreadPool& pool = ThreadPool::Instance();
+		if (threadCount == 0 || threadCount > pool.GetThreadCount())
+			threadCount = pool.GetThreadCount();
+
+		//a few bands per thread keeps the threads busy when some of them start late
+		const uint32 bh = EndBlockRow(job) - FirstBlockRow(job);
+		job.bandCount = threadCount * 4 < bh ? threadCount * 4 : bh;
+		pool.Run(TranscodeBand, &job, job.bandCount, threadCount);
+	}
+
+	static void TranscodeBands(TranscodeJob& job, TTParallelFor parallelFor, void* userData, uint32 taskCount)
+	{
+		const uint32 bh = EndBlockRow(job) - FirstBlockRow(job);
+		job.bandCount = taskCount == 0 ? 1 : (taskCount < bh ? taskCount : bh);
+		if (job.bandCount == 0)
+			return;
+		parallelFor(userData, TranscodeBand, &job, job.bandCount);
+	}
 
-	//Table C.10: Intensity modifier sets for alpha component.
-	static const int32 intensityModifierAlpha[16][8] =
-	{
-		{ -3, -6,  -9, -15, 2, 5, 8, 14 },
-		{ -3, -7, -10, -13, 2, 6, 9, 12 },
-		{ -2, -5,  -8, -13, 1, 4, 7, 12 },
-		{ -2, -4,  -6, -13, 1, 3, 5, 12 },
-		{ -3, -6,  -8, -12, 2, 5, 7, 11 },
-		{ -3, -7,  -9, -11, 2, 6, 8, 10 },
-		{ -4, -7,  -8, -11, 3, 6, 7, 10 },
-		{ -3, -5,  -8, -11, 2, 4, 7, 10 },
-		{ -2, -6,  -8, -10, 1, 5, 7,  9 },
-		{ -2, -5,  -8, -10, 1, 4, 7,  9 },
-		{ -2, -4,  -8, -10, 1, 3, 7,  9 },
-		{ -2, -5,  -7, -10, 1, 4, 6,  9 },
-		{ -3, -4,  -7, -10, 2, 3, 6,  9 },
-		{ -1, -2,  -3, -10, 0, 1, 2,  9 },
-		{ -4, -6,  -8,  -9, 3, 5, 7,  8 },
-		{ -3, -5,  -7,  -9, 2, 4, 6,  8 }
+	//An _Async call, owned by the dispatch thread from Post on
+	struct AsyncTranscodeJob
+	{
+		TranscodeJob job;
+		uint32 threadCount;
+		StatsSource statsSource;
 	};
 
-	class EACBlock
+	static void RunAsyncTranscode(void* taskData, uint32 /*taskIndex*/)
 	{
-	private:
-		uint32 part0;
-		uint32 part1;
-	public:
-		void Decode(uint8* dest, uint32 destRowPitch) const
+		AsyncTranscodeJob* async = (AsyncTranscodeJob*)taskData;
 		{
-			//	uint8 base_codeword : 8;
-			//	uint8 table_index : 4;
-			//	uint8 multiplier : 4;
-			//	uint8 mc1 : 2; 16
-			//	uint8 mb : 3;  18
-			//	uint8 ma : 3;  21
-			//	uint8 mf1 : 1; 24
-			//	uint8 me : 3;  25
-			//	uint8 md : 3;  28
-			//	uint8 mc2 : 1; 31
-			//	uint8 mh : 3;  0
-			//	uint8 mg : 3;  3
-			//	uint8 mf2 : 2; 6
-			//	uint8 mk1 : 2; 8
-			//	uint8 mj : 3;  10
-			//	uint8 mi : 3;  13
-			//	uint8 mn1 : 1; 16
-			//	uint8 mm : 3;  17
-			//	uint8 ml : 3;  20
-			//	uint8 mk2 : 1; 23
-			//	uint8 mp : 3;  24
-			//	uint8 mo : 3;  27
-			//	uint8 mn2 : 2; 30
-			int32 base_codeword = part0 & 0xFF;
-			uint32 table_index = (part0 >> 8) & 0xF;
-			int32 multiplier = (part0 >> 12) & 0xF;
-
-			static uint32 index_array[16];
-			index_array[0] = (part0 >> 21) & 0x7;                                 //a
-			index_array[1] = (part0 >> 18) & 0x7;                                 //b
-			index_array[2] = (((part0 >> 16) & 0x3) << 1) | (part0 >> 31);        //c
-			index_array[3] = (part0 >> 28) & 0x7;                                 //d
-			index_array[4] = (part0 >> 25) & 0x7;                                 //e
-			index_array[5] = (((part0 >> 24) & 0x1) << 2) | ((part1 >> 6) & 0x3); //f
-			index_array[6] = (part1 >> 3) & 0x7;                                  //g
-			index_array[7] = part1 & 0x7;			                              //h
-			index_array[8] = (part1 >> 13) & 0x7;                                 //i
-			index_array[9] = (part1 >> 10) & 0x7;                                 //j
-			index_array[10] = (((part1 >> 8) & 0x3) << 1) | ((part1 >> 23) & 0x1);//k
-			index_array[11] = (part1 >> 20) & 0x7;                                //l
-			index_array[12] = (part1 >> 17) & 0x7;                                //m
-			index_array[13] = (((part1 >> 16) & 0x1) << 2) | ((part1 >> 30));     //n
-			index_array[14] = (part1 >> 27) & 0x7;                                //o
-			index_array[15] = (part1 >> 24) & 0x7;                                //p
-
-			for (uint32 j = 0; j < 4; j++)
-			{
-				for (uint32 i = 0; i < 4; i++)
-				{
-					const uint32 destIndex = j * destRowPitch + i * 4;
-					dest[destIndex + 3] = ClampUint8(base_codeword + multiplier * intensityModifierAlpha[table_index][index_array[i * 4 + j]]);
-				}
-			}
+			//timed on the dispatch thread, the call itself only posts
+			TT_STATS_SCOPE(async->statsSource, async->job.source, async->job.width, async->job.height, (uint64)async->job.width * async->job.height * async->job.pixelSize);
+			TranscodeBands(async->job, async->threadCount);
 		}
-	};
+		delete async;
+	}
 
-	void TranscodeETC2_to_RGBA8(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	static void PostTranscode(const TranscodeJob& job, StatsSource statsSource, uint32 threadCount, uint32* done)
 	{
-		const uint32 bw = (width + 3) / 4;  //block width
-		const uint32 bh = (height + 3) / 4; //block height
+		AsyncTranscodeJob* async = new AsyncTranscodeJob;
+		async->job = job;
+		async->threadCount = threadCount;
+		async->statsSource = statsSource;
+		ThreadPool::Instance().Post(RunAsyncTranscode, async, done);
+	}
 
-		uint32 destRowPitch = Max(width * 4, 16);
-		for (uint32 by = 0; by < bh; ++by)
-		{
-			for (uint32 bx = 0; bx < bw; ++bx)
-			{
-				uint32 destOffset = by * 4 * destRowPitch + bx * 16;
+	void TranscodeImageRows(DecodeRowFunc decodeRow, uint32 blockSize, const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 pixelSize)
+	{
+		const TranscodeJob job = MakeTranscodeJob(decodeRow, blockSize, source, dest, width, height, pixelSize);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
 
-				const ETC2Block* pETC2Block = (ETC2Block*)source;
-				pETC2Block->Decode(dest+destOffset, destRowPitch);
+	void TranscodeBlockRows(DecodeRowFunc decodeRow, uint32 blockSize, const uint8* source, uint8* dest, const uint32 destRowPitch, const uint32 width, const uint32 height, const uint32 byBegin, const uint32 byEnd)
+	{
+		//a sub-image starting at block row byBegin
+		TranscodeJob job = MakeTranscodeJob(decodeRow, blockSize, source, dest, width, Min(height - byBegin * 4, (byEnd - byBegin) * 4));
+		job.destRowPitch = destRowPitch;
+		TranscodeRows(job, 0, byEnd - byBegin);
+	}
 
-				source += 8;
-			}
-		}
+	void TranscodeETC2_to_RGBA8(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, (uint64)width * height * 4);
+		const TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2Row, 8, source, dest, width, height);
+		TranscodeRows(job, 0, (height + 3) / 4);
 	}
 
 	void TranscodeETC2_EAC_to_RGBA8(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
 	{
-		const uint32 bw = (width + 3) / 4;  //block width
-		const uint32 bh = (height + 3) / 4; //block height
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, (uint64)width * height * 4);
+		const TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2EACRow, 16, source, dest, width, height);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
 
-		uint32 destRowPitch = Max(width * 4, 16);
-		for (uint32 by = 0; by < bh; ++by)
-		{
-			for (uint32 bx = 0; bx < bw; ++bx)
-			{
-				uint32 destOffset = by * 4 * destRowPitch + bx * 16;
+	void TranscodeETC2_A1_to_RGBA8(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2A1, source, width, height, (uint64)width * height * 4);
+		const TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2A1Row, 8, source, dest, width, height);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
+
+	void TranscodeETC2_to_RGBA8_Rect(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const TTRect* rect)
+	{
+		TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2Row, 8, source, dest, width, height);
+		SetTranscodeRect(job, destRowPitch, rect);
+		TranscodeRows(job, FirstBlockRow(job), EndBlockRow(job));
+	}
 
-				const ETC2Block* pETC2Block = (ETC2Block*)(source+8);
-				pETC2Block->Decode(dest + destOffset, destRowPitch);
+	void TranscodeETC2_EAC_to_RGBA8_Rect(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const TTRect* rect)
+	{
+		TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2EACRow, 16, source, dest, width, height);
+		SetTranscodeRect(job, destRowPitch, rect);
+		TranscodeRows(job, FirstBlockRow(job), EndBlockRow(job));
+	}
 
+	void TranscodeETC2_A1_to_RGBA8_Rect(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const TTRect* rect)
+	{
+		TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2A1Row, 8, source, dest, width, height);
+		SetTranscodeRect(job, destRowPitch, rect);
+		TranscodeRows(job, FirstBlockRow(job), EndBlockRow(job));
+	}
 
-				//ETC2Block.Decode will cover alpha channel with 255, so call EACBlock.Decode after ETC2Block.Decode
-				const EACBlock* pEACBlock = (EACBlock*)source;
-				pEACBlock->Decode(dest + destOffset, destRowPitch);
+	void TranscodeETC2_to_RGBA8_MT(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 threadCount)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, (uint64)width * height * 4);
+		TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2Row, 8, source, dest, width, height);
+		TranscodeBands(job, threadCount);
+	}
 
-				source += 16;
-			}
-		}
+	void TranscodeETC2_EAC_to_RGBA8_MT(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 threadCount)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, (uint64)width * height * 4);
+		TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2EACRow, 16, source, dest, width, height);
+		TranscodeBands(job, threadCount);
+	}
+
+	void TranscodeETC2_to_RGBA8_Tasks(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTParallelFor parallelFor, void* userData, const uint32 taskCount)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, (uint64)width * height * 4);
+		TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2Row, 8, source, dest, width, height);
+		TranscodeBands(job, parallelFor, userData, taskCount);
+	}
+
+	void TranscodeETC2_EAC_to_RGBA8_Tasks(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTParallelFor parallelFor, void* userData, const uint32 taskCount)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, (uint64)width * height * 4);
+		TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2EACRow, 16, source, dest, width, height);
+		TranscodeBands(job, parallelFor, userData, taskCount);
+	}
+
+	void TranscodeETC2_to_RGBA8_Async(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 threadCount, uint32* done)
+	{
+		PostTranscode(MakeTranscodeJob(GetKernels().decodeETC2Row, 8, source, dest, width, height), StatsSourceETC2, threadCount, done);
+	}
+
+	void TranscodeETC2_EAC_to_RGBA8_Async(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 threadCount, uint32* done)
+	{
+		PostTranscode(MakeTranscodeJob(GetKernels().decodeETC2EACRow, 16, source, dest, width, height), StatsSourceETC2EAC, threadCount, done);
+	}
+
+	void TranscodeETC2_to_RGBA8_Batched(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTETC2ModeCounts* modeCounts)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, (uint64)width * height * 4);
+		const TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2Row, 8, source, dest, width, height);
+		TranscodeRowsBatched(job, 0, (height + 3) / 4, modeCounts);
+	}
+
+	void TranscodeETC2_EAC_to_RGBA8_Batched(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTETC2ModeCounts* modeCounts)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, (uint64)width * height * 4);
+		const TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2EACRow, 16, source, dest, width, height);
+		TranscodeRowsBatched(job, 0, (height + 3) / 4, modeCounts);
+	}
+
+	void TranscodeETC2_to_RGBA8_Cached(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTBlockCacheStats* stats)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, (uint64)width * height * 4);
+		const TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2Row, 8, source, dest, width, height);
+		TranscodeRowsCached(job, 0, (height + 3) / 4, stats);
+	}
+
+	void TranscodeETC2_EAC_to_RGBA8_Cached(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTBlockCacheStats* stats)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, (uint64)width * height * 4);
+		const TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2EACRow, 16, source, dest, width, height);
+		TranscodeRowsCached(job, 0, (height + 3) / 4, stats);
+	}
+
+	static DecodeRowFunc GetEACChannelRow(bool isSigned, uint32 channels, bool is16Bits)
+	{
+		return GetKernels().decodeEACChannelRows[GetEACChannelRowIndex(isSigned, channels, is16Bits)];
+	}
+
+	void TranscodeEAC_R11_to_R16(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceEACR11, source, width, height, (uint64)width * height * 2);
+		const TranscodeJob job = MakeTranscodeJob(GetEACChannelRow(false, 1, true), 8, source, dest, width, height, 2);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
+
+	void TranscodeEAC_R11_to_R8(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceEACR11, source, width, height, (uint64)width * height);
+		const TranscodeJob job = MakeTranscodeJob(GetEACChannelRow(false, 1, false), 8, source, dest, width, height, 1);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
+
+	void TranscodeEAC_RG11_to_RG16(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceEACRG11, source, width, height, (uint64)width * height * 4);
+		const TranscodeJob job = MakeTranscodeJob(GetEACChannelRow(false, 2, true), 16, source, dest, width, height, 4);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
+
+	void TranscodeEAC_RG11_to_RG8(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceEACRG11, source, width, height, (uint64)width * height * 2);
+		const TranscodeJob job = MakeTranscodeJob(GetEACChannelRow(false, 2, false), 16, source, dest, width, height, 2);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
+
+	void TranscodeEAC_SIGNED_R11_to_R16(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceEACR11, source, width, height, (uint64)width * height * 2);
+		const TranscodeJob job = MakeTranscodeJob(GetEACChannelRow(true, 1, true), 8, source, dest, width, height, 2);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
+
+	void TranscodeEAC_SIGNED_R11_to_R8(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceEACR11, source, width, height, (uint64)width * height);
+		const TranscodeJob job = MakeTranscodeJob(GetEACChannelRow(true, 1, false), 8, source, dest, width, height, 1);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
+
+	void TranscodeEAC_SIGNED_RG11_to_RG16(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceEACRG11, source, width, height, (uint64)width * height * 4);
+		const TranscodeJob job = MakeTranscodeJob(GetEACChannelRow(true, 2, true), 16, source, dest, width, height, 4);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
+
+	void TranscodeEAC_SIGNED_RG11_to_RG8(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceEACRG11, source, width, height, (uint64)width * height * 2);
+		const TranscodeJob job = MakeTranscodeJob(GetEACChannelRow(true, 2, false), 16, source, dest, width, height, 2);
+		TranscodeRows(job, 0, (height + 3) / 4);
+	}
+
+	void TranscodeETC2_to_RGBA8_Mips(const uint8* source, uint8* dest, const uint32 width, const uint32 height, uint8* const* mipDests, const uint32 mipCount)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, GetMipChainBytes(width, height, mipCount));
+		const TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2Row, 8, source, dest, width, height);
+		TranscodeRowsMips(job, mipDests, mipCount);
+	}
+
+	void TranscodeETC2_EAC_to_RGBA8_Mips(const uint8* source, uint8* dest, const uint32 width, const uint32 height, uint8* const* mipDests, const uint32 mipCount)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, GetMipChainBytes(width, height, mipCount));
+		const TranscodeJob job = MakeTranscodeJob(GetKernels().decodeETC2EACRow, 16, source, dest, width, height);
+		TranscodeRowsMips(job, mipDests, mipCount);
 	}
 }
\ No newline at end of file
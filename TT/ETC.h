@@ -1,16 +1,197 @@
 #pragma once
 #include "BaseType.h"
+#include "ThreadPool.h"
 
 namespace TT
 {
 	extern "C" {
+		enum TTETC2Mode
+		{
+			TT_ETC2_MODE_INDIVIDUAL,
+			TT_ETC2_MODE_DIFFERENTIAL,
+			TT_ETC2_MODE_T,
+			TT_ETC2_MODE_H,
+			TT_ETC2_MODE_PLANAR,
+			TT_ETC2_MODE_COUNT
+		};
+
+		//Instruction set of the transcode kernels, TT_ISA_AUTO is the best one the CPU supports
+		enum TTKernelISA
+		{
+			TT_ISA_AUTO,
+			TT_ISA_SCALAR,
+			TT_ISA_SSE41,
+			TT_ISA_SIMD128,
+		};
+
+		//Number of blocks decoded in each TTETC2Mode
+		struct TTETC2ModeCounts
+		{
+			uint32 blocks[TT_ETC2_MODE_COUNT];
+		};
+
+		//Blocks seen by the _Cached transcoders and how many of them were copied instead of decoded
+		struct TTBlockCacheStats
+		{
+			uint32 blocks;
+			uint32 repeatHits; //same bytes as the block to the left
+			uint32 cacheHits; //same bytes as a recent block in the cache
+		};
+
+		//Totals of the whole-image ETC2 and EAC R11/RG11 transcoders since the last TTResetStats, only counted in builds with
+		//TT_ENABLE_STATS=1. _Async calls are counted when the dispatch thread has run them. Not counted: the _Rect calls,
+		//StreamTranscoder, TranscodeContext, the RGBA8 to ETC encoders and the BC transcoders. Every field is a uint64.
+		struct TTStats
+		{
+			uint64 calls;
+			uint64 etc2Blocks[TT_ETC2_MODE_COUNT]; //color blocks by TTETC2Mode, punch-through blocks by the mode they decode in
+			uint64 eacBlocks; //alpha blocks, and every R11 channel block (two per RG11 block)
+			uint64 eacZeroMultiplierBlocks; //EAC blocks with multiplier 0
+			uint64 bytesIn;
+			uint64 bytesOut;
+			uint64 nanoseconds; //wall time inside the calls, not counting the block scan of the stats
+			uint64 lastCallNanoseconds;
+			uint64 maxCallNanoseconds;
+		};
+
+		//Speed/quality presets of the RGBA8 to ETC encoders
+		enum TTETCQuality
+		{
+			TT_ETC_QUALITY_FAST, //one flip picked up front, table from the luminance offsets, for per-frame encodes
+			TT_ETC_QUALITY_NORMAL, //both flips fitted exactly, ETC2 also tries planar
+			TT_ETC_QUALITY_HIGH, //refined base colors, ETC2 also tries T and H
+		};
+
+		//Output transforms of the _Transform transcoders, any combination of the bits. The sRGB conversion comes first,
+		//premultiplying then works on the converted color.
+		enum TTOutputTransform
+		{
+			TT_TRANSFORM_SRGB_TO_LINEAR = 1, //e.g. SRGB8_ALPHA8_ETC2_EAC data for a linear RGBA8 target, alpha is unchanged
+			TT_TRANSFORM_LINEAR_TO_SRGB = 2,
+			TT_TRANSFORM_PREMULTIPLY = 4, //color * alpha / 255, rounded
+			TT_TRANSFORM_BGRA = 8, //swap red and blue
+			TT_TRANSFORM_FLIP_Y = 16, //last row first, for bottom-up upload APIs
+		};
+
+		//Pixel order of the _Layout transcoders
+		enum TTOutputLayout
+		{
+			TT_LAYOUT_LINEAR, //row-major, rows Max(width, 4) * 4 bytes apart as TranscodeETC2_to_RGBA8
+			TT_LAYOUT_TILED_4X4, //every 4x4 block is a 64 byte tile of row-major pixels, tiles in row-major block order
+			TT_LAYOUT_MORTON, //Z-order of the pixels, every 4x4 block is a 64 byte tile
+		};
+
+		//Pixel rectangle of an image
+		struct TTRect
+		{
+			uint32 x;
+			uint32 y;
+			uint32 width;
+			uint32 height;
+		};
+
+		//Copy the stats into stats and return 1, or zero them and return 0 when built without TT_ENABLE_STATS
+		TT_EXPORT uint32 TTGetStats(TTStats* stats);
+		TT_EXPORT void TTResetStats();
+
+		//Force the kernels of isa for every transcoder, e.g. to test the scalar path on an SSE4.1 machine.
+		//Returns 0 and keeps the current kernels when isa isn't built in or the CPU lacks it.
+		TT_EXPORT uint32 TTSetKernelISA(TTKernelISA isa);
+		TT_EXPORT TTKernelISA TTGetKernelISA();
+
 		TT_EXPORT void TranscodeETC2_to_RGBA8(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
 		TT_EXPORT void TranscodeETC2_EAC_to_RGBA8(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
 
-		//void TranscodeETC2_EAC_to_RGBA4();
+		//COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, blocks without the opaque bit have transparent black pixels (alpha 0)
+		TT_EXPORT void TranscodeETC2_A1_to_RGBA8(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+
+		//Decode the pixels of rect (the whole image when rect is null) into dest, dest points at the top-left pixel of rect
+		//and its rows are destRowPitch bytes apart. Edge blocks are clipped, nothing is written outside rect.
+		TT_EXPORT void TranscodeETC2_to_RGBA8_Rect(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const TTRect* rect);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA8_Rect(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const TTRect* rect);
+		TT_EXPORT void TranscodeETC2_A1_to_RGBA8_Rect(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const TTRect* rect);
+
+		//Decode with the TTOutputTransform bits of transform applied to each block before it is stored, dest rows are
+		//destRowPitch bytes apart (0 for width * 4). Every combination of bits is its own specialization, transform 0
+		//is the plain decoder.
+		TT_EXPORT void TranscodeETC2_to_RGBA8_Transform(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const uint32 transform);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA8_Transform(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const uint32 transform);
+		TT_EXPORT void TranscodeETC2_A1_to_RGBA8_Transform(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const uint32 transform);
+
+		//Decode into the pixel order of layout, tiled layouts store every block as one contiguous 64 byte write and edge tiles
+		//hold the whole decoded block. Morton interleaves the block coordinates, x first, as far as the shorter side goes
+		//(rounded up to a power of two), the longer side's remaining bits come on top. dest needs TTGetOutputLayoutSize bytes.
+		TT_EXPORT void TranscodeETC2_to_RGBA8_Layout(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const TTOutputLayout layout);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA8_Layout(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const TTOutputLayout layout);
+		TT_EXPORT void TranscodeETC2_A1_to_RGBA8_Layout(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const TTOutputLayout layout);
+		TT_EXPORT uint32 TTGetOutputLayoutSize(const TTOutputLayout layout, const uint32 width, const uint32 height);
+
+		//Split the block rows into bands decoded on the internal thread pool, threadCount 0 uses every hardware thread.
+		//The output is identical to the serial functions.
+		TT_EXPORT void TranscodeETC2_to_RGBA8_MT(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 threadCount);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA8_MT(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 threadCount);
+
+		//Same as _MT but the taskCount bands are scheduled by the caller's parallelFor
+		TT_EXPORT void TranscodeETC2_to_RGBA8_Tasks(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTParallelFor parallelFor, void* userData, const uint32 taskCount);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA8_Tasks(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTParallelFor parallelFor, void* userData, const uint32 taskCount);
+
+		//Return at once and decode as _MT on the pool's dispatch thread, *done is set to 1 once dest is complete.
+		//source and dest must stay valid until then, calls are decoded in the order they were made. For callers that must
+		//not block, e.g. the browser main thread with the threaded Emscripten build.
+		TT_EXPORT void TranscodeETC2_to_RGBA8_Async(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 threadCount, uint32* done);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA8_Async(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 threadCount, uint32* done);
+
+		//Two-phase decode: every block row is first bucketed by mode, then each bucket is decoded in a loop without mode branches.
+		//The output matches TranscodeETC2_to_RGBA8, the mode mix is added to modeCounts when it isn't null.
+		TT_EXPORT void TranscodeETC2_to_RGBA8_Batched(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTETC2ModeCounts* modeCounts);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA8_Batched(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTETC2ModeCounts* modeCounts);
+
+		//For images with many identical blocks (padding, flat colors, repeated tiles): a block equal to the one to its left
+		//or to one of the last few hundred distinct blocks is copied from the pixels already written. The output matches
+		//TranscodeETC2_to_RGBA8, the hits are added to stats when it isn't null.
+		TT_EXPORT void TranscodeETC2_to_RGBA8_Cached(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTBlockCacheStats* stats);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA8_Cached(const uint8* source, uint8* dest, const uint32 width, const uint32 height, TTBlockCacheStats* stats);
+
+		//Decode into dest and box filter mip levels 1..mipCount into mipDests[0..mipCount-1] in the same pass, each level
+		//is built block row by block row from the level above while it is in cache instead of re-reading the whole image.
+		//Level n is Max(width >> n, 1) x Max(height >> n, 1) RGBA8 pixels with rows 4 * Max(width >> n, 1) bytes apart,
+		//a pixel is the rounded average of its 2x2 pixels on the level above, an odd last row or column is dropped and a level
+		//1 pixel wide or high averages its single column or row with itself.
+		TT_EXPORT void TranscodeETC2_to_RGBA8_Mips(const uint8* source, uint8* dest, const uint32 width, const uint32 height, uint8* const* mipDests, const uint32 mipCount);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA8_Mips(const uint8* source, uint8* dest, const uint32 width, const uint32 height, uint8* const* mipDests, const uint32 mipCount);
+
+		//EAC R11 and RG11 (two R11 blocks per 4x4 block), into 16 bits per channel or the high 8 bits.
+		//The SIGNED variants write int16/int8 snorm values.
+		TT_EXPORT void TranscodeEAC_R11_to_R16(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+		TT_EXPORT void TranscodeEAC_R11_to_R8(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+		TT_EXPORT void TranscodeEAC_RG11_to_RG16(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+		TT_EXPORT void TranscodeEAC_RG11_to_RG8(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+		TT_EXPORT void TranscodeEAC_SIGNED_R11_to_R16(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+		TT_EXPORT void TranscodeEAC_SIGNED_R11_to_R8(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+		TT_EXPORT void TranscodeEAC_SIGNED_RG11_to_RG16(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+		TT_EXPORT void TranscodeEAC_SIGNED_RG11_to_RG8(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+
+		//16 bit pixels in the GL packed layouts (GL_UNSIGNED_SHORT_5_6_5, _4_4_4_4, _5_5_5_1), rows width * 2 bytes apart.
+		//Channels are rounded to nearest, dither != 0 applies a 4x4 ordered dither to red, green and blue instead.
+		TT_EXPORT void TranscodeETC2_to_RGB565(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 dither);
+		TT_EXPORT void TranscodeETC2_A1_to_RGBA5551(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 dither);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA4444(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 dither);
+		TT_EXPORT void TranscodeETC2_EAC_to_RGBA5551(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 dither);
+
+		//Block to block, BC1 endpoints are picked from the ETC2 block palette and the EAC alpha is re-quantized into the BC3 alpha block.
+		//dest holds one 8 (BC1) or 16 (BC3) byte block per source block.
+		TT_EXPORT void TranscodeETC2_to_BC1(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+		TT_EXPORT void TranscodeETC2_EAC_to_BC3(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+
+		//Same as the BC transcoders with ATC endpoints (color0 RGB555, color1 RGB565, colors at 3/8 and 5/8 between them).
+		//ATC_RGBA_INTERPOLATED_ALPHA_AMD uses the BC3 alpha block.
+		TT_EXPORT void TranscodeETC2_to_ATC_RGB(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+		TT_EXPORT void TranscodeETC2_EAC_to_ATC_RGBA(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
 
-		//void TranscodeETC2_to_BC1();
-		//void TranscodeETC2_EAC_to_BC3();
+		//Encode RGBA8 pixels (rows sourceRowPitch bytes apart, 0 for width * 4) into ETC1 or ETC2 RGB blocks, alpha is ignored.
+		//Partial edge blocks repeat the last column and row. ETC1 blocks are valid ETC2 blocks.
+		TT_EXPORT void TranscodeRGBA8_to_ETC1(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 sourceRowPitch, const TTETCQuality quality);
+		TT_EXPORT void TranscodeRGBA8_to_ETC2(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 sourceRowPitch, const TTETCQuality quality);
 
 		//void TranscodeETC2_to_PVRTC();
 	}
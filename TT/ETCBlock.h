@@ -0,0 +1,1308 @@
+#pragma once
+//modified from Angle's loadimage_etc
+//https://github.com/google/angle/blob/master/src/image_util/loadimage_etc.cpp
+//
+// Copyright (c) 2013-2015 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "ColorBlock.h"
+#include "Math.h"
+namespace TT
+{
+	// Table 3.17.2 sorted according to table 3.17.3
+	static const int32 intensityModifierDefault[8][4] =
+	{
+		{ 2,   8,  -2,   -8 },
+		{ 5,  17,  -5,  -17 },
+		{ 9,  29,  -9,  -29 },
+		{ 13,  42, -13,  -42 },
+		{ 18,  60, -18,  -60 },
+		{ 24,  80, -24,  -80 },
+		{ 33, 106, -33, -106 },
+		{ 47, 183, -47, -183 },
+	};
+
+	// Table C.12, intensity modifier for non opaque punchthrough alpha
+	static const int32 intensityModifierNonOpaque[8][4] =
+	{
+		{ 0,   8, 0,   -8 },
+		{ 0,  17, 0,  -17 },
+		{ 0,  29, 0,  -29 },
+		{ 0,  42, 0,  -42 },
+		{ 0,  60, 0,  -60 },
+		{ 0,  80, 0,  -80 },
+		{ 0, 106, 0, -106 },
+		{ 0, 183, 0, -183 },
+	};
+
+	// Table C.8, distance index for T and H modes
+	static const int32 distanceTableTH[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+	// intensityModifierDefault for SIMD palette builds, split into the part added to the base color (entries 0, 1)
+	// and the part subtracted from it (entries 2, 3), alpha lanes untouched
+	alignas(16) static const uint8 modifierAdd[8][16] =
+	{
+		{  2,  2,  2, 0,   8,   8,   8, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+		{  5,  5,  5, 0,  17,  17,  17, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+		{  9,  9,  9, 0,  29,  29,  29, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+		{ 13, 13, 13, 0,  42,  42,  42, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+		{ 18, 18, 18, 0,  60,  60,  60, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+		{ 24, 24, 24, 0,  80,  80,  80, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+		{ 33, 33, 33, 0, 106, 106, 106, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+		{ 47, 47, 47, 0, 183, 183, 183, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+	};
+
+	alignas(16) static const uint8 modifierSub[8][16] =
+	{
+		{ 0, 0, 0, 0, 0, 0, 0, 0,  2,  2,  2, 0,   8,   8,   8, 0 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0,  5,  5,  5, 0,  17,  17,  17, 0 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0,  9,  9,  9, 0,  29,  29,  29, 0 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 13, 13, 13, 0,  42,  42,  42, 0 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 18, 0,  60,  60,  60, 0 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 24, 24, 24, 0,  80,  80,  80, 0 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 33, 33, 33, 0, 106, 106, 106, 0 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0, 47, 47, 47, 0, 183, 183, 183, 0 },
+	};
+
+	//intensityModifierDefault by entry for scoring the 8 tables side by side, 16-bit lane t holds table t
+	alignas(16) static const int16 modifierColumns[4][8] =
+	{
+		{  2,   5,   9,  13,  18,  24,   33,   47 },
+		{  8,  17,  29,  42,  60,  80,  106,  183 },
+		{ -2,  -5,  -9, -13, -18, -24,  -33,  -47 },
+		{ -8, -17, -29, -42, -60, -80, -106, -183 },
+	};
+
+	//Table C.10 widened to 16 bits for SIMD multiplies
+	alignas(16) static const int16 modifierAlpha[16][8] =
+	{
+		{ -3, -6,  -9, -15, 2, 5, 8, 14 },
+		{ -3, -7, -10, -13, 2, 6, 9, 12 },
+		{ -2, -5,  -8, -13, 1, 4, 7, 12 },
+		{ -2, -4,  -6, -13, 1, 3, 5, 12 },
+		{ -3, -6,  -8, -12, 2, 5, 7, 11 },
+		{ -3, -7,  -9, -11, 2, 6, 8, 10 },
+		{ -4, -7,  -8, -11, 3, 6, 7, 10 },
+		{ -3, -5,  -8, -11, 2, 4, 7, 10 },
+		{ -2, -6,  -8, -10, 1, 5, 7,  9 },
+		{ -2, -5,  -8, -10, 1, 4, 7,  9 },
+		{ -2, -4,  -8, -10, 1, 3, 7,  9 },
+		{ -2, -5,  -7, -10, 1, 4, 6,  9 },
+		{ -3, -4,  -7, -10, 2, 3, 6,  9 },
+		{ -1, -2,  -3, -10, 0, 1, 2,  9 },
+		{ -4, -6,  -8,  -9, 3, 5, 7,  8 },
+		{ -3, -5,  -7,  -9, 2, 4, 6,  8 }
+	};
+
+/*
+https://www.khronos.org/registry/OpenGL/extensions/OES/OES_compressed_ETC1_RGB8_texture.txt
+ETC1_RGB8_OES:
+
+a) bit layout in bits 63 through 32 if diffbit = 0
+
+ 63 62 61 60 59 58 57 56 55 54 53 52 51 50 49 48
+ -----------------------------------------------
+| base col1 | base col2 | base col1 | base col2 |
+| R1 (4bits)| R2 (4bits)| G1 (4bits)| G2 (4bits)|
+ -----------------------------------------------
+
+ 47 46 45 44 43 42 41 40 39 38 37 36 35 34  33  32
+ ---------------------------------------------------
+| base col1 | base col2 | table  | table  |diff|flip|
+| B1 (4bits)| B2 (4bits)| cw 1   | cw 2   |bit |bit |
+ ---------------------------------------------------
+
+
+b) bit layout in bits 63 through 32 if diffbit = 1
+
+ 63 62 61 60 59 58 57 56 55 54 53 52 51 50 49 48
+ -----------------------------------------------
+| base col1    | dcol 2 | base col1    | dcol 2 |
+| R1' (5 bits) | dR2    | G1' (5 bits) | dG2    |
+ -----------------------------------------------
+
+ 47 46 45 44 43 42 41 40 39 38 37 36 35 34  33  32
+ ---------------------------------------------------
+| base col 1   | dcol 2 | table  | table  |diff|flip|
+| B1' (5 bits) | dB2    | cw 1   | cw 2   |bit |bit |
+ ---------------------------------------------------
+
+
+c) bit layout in bits 31 through 0 (in both cases)
+
+ 31 30 29 28 27 26 25 24 23 22 21 20 19 18 17 16
+ -----------------------------------------------
+|       most significant pixel index bits       |
+| p| o| n| m| l| k| j| i| h| g| f| e| d| c| b| a|
+ -----------------------------------------------
+
+ 15 14 13 12 11 10  9  8  7  6  5  4  3   2   1  0
+ --------------------------------------------------
+|         least significant pixel index bits       |
+| p| o| n| m| l| k| j| i| h| g| f| e| d| c | b | a |
+ --------------------------------------------------
+*/
+//https://www.khronos.org/registry/OpenGL/specs/es/3.0/es_spec_3.0.pdf page293
+
+	class ETC2Block
+	{
+	private:
+		union {
+			// Individual, differential, H and T modes
+			struct
+			{
+				union {
+					// Individual and differential modes
+					struct
+					{
+						union {
+							struct  // Individual colors
+							{
+								uint8 R2 : 4;
+								uint8 R1 : 4;
+								uint8 G2 : 4;
+								uint8 G1 : 4;
+								uint8 B2 : 4;
+								uint8 B1 : 4;
+							} indiv;
+							struct  // Differential colors
+							{
+								int8 dR : 3;
+								uint8 R : 5;
+								int8 dG : 3;
+								uint8 G : 5;
+								int8 dB : 3;
+								uint8 B : 5;
+							} diff;
+						} colors;
+						bool flipbit : 1;
+						bool diffbit : 1;
+						uint8 cw2 : 3;
+						uint8 cw1 : 3;
+					} idm;
+					// T mode
+					struct
+					{
+						// Byte 1
+						uint8 TR1b : 2;
+						uint8 TdummyB : 1;
+						uint8 TR1a : 2;
+						uint8 TdummyA : 3;
+						// Byte 2
+						uint8 TB1 : 4;
+						uint8 TG1 : 4;
+						// Byte 3
+						uint8 TG2 : 4;
+						uint8 TR2 : 4;
+						// Byte 4
+						uint8 Tdb : 1;
+						bool Tflipbit : 1;
+						uint8 Tda : 2;
+						uint8 TB2 : 4;
+					} tm;
+					// H mode
+					struct
+					{
+						// Byte 1
+						uint8 HG1a : 3;
+						uint8 HR1 : 4;
+						uint8 HdummyA : 1;
+						// Byte 2
+						uint8 HB1b : 2;
+						uint8 HdummyC : 1;
+						uint8 HB1a : 1;
+						uint8 HG1b : 1;
+						uint8 HdummyB : 3;
+						// Byte 3
+						uint8 HG2a : 3;
+						uint8 HR2 : 4;
+						uint8 HB1c : 1;
+						// Byte 4
+						uint8 Hdb : 1;
+						bool Hflipbit : 1;
+						uint8 Hda : 1;
+						uint8 HB2 : 4;
+						uint8 HG2b : 1;
+					} hm;
+				} mode;
+				uint8 pixelIndexMSB[2];
+				uint8 pixelIndexLSB[2];
+			} idht;
+			// planar mode
+			struct
+			{
+				// Byte 1
+				uint8 GO1 : 1;
+				uint8 RO : 6;
+				uint8 PdummyA : 1;
+				// Byte 2
+				uint8 BO1 : 1;
+				uint8 GO2 : 6;
+				uint8 PdummyB : 1;
+				// Byte 3
+				uint8 BO3a : 2;
+				uint8 PdummyD : 1;
+				uint8 BO2 : 2;
+				uint8 PdummyC : 3;
+				// Byte 4
+				uint8 RH2 : 1;
+				bool Pflipbit : 1;
+				uint8 RH1 : 5;
+				uint8 BO3b : 1;
+				// Byte 5
+				uint8 BHa : 1;
+				uint8 GH : 7;
+				// Byte 6
+				uint8 RVa : 3;
+				uint8 BHb : 5;
+				// Byte 7
+				uint8 GVa : 5;
+				uint8 RVb : 3;
+				// Byte 8
+				uint8 BV : 6;
+				uint8 GVb : 2;
+			} pblk;
+			struct
+			{
+				uint32 part0;
+				uint32 part1;
+			};
+		} u;
+
+	public:
+		void Decode1(uint8* dest, uint32 destRowPitch) const
+		{
+			// Select mode
+			//uint32 diff = (u.part0 >> 24) & 0x2;
+			//if (diff)
+			if(u.idht.mode.idm.diffbit)
+			{
+				//int32  R = (u.part0 >> 3) & 0x1F;
+				//int32 dR = ((u.part0 & 0x7) << 29) >> 29;
+				//int32  G = (u.part0 >> 11) & 0x1F;
+				//int32 dG = (((u.part0 >> 8) & 0x7) << 29) >> 29;
+				//int32  B = (u.part0 >> 19) & 0x1F;
+				//int32 dB = (((u.part0 >> 16) & 0x7) << 29) >> 29;
+				//int32 r = (R + dR);
+				//int32 g = (G + dG);
+				//int32 b = (B + dB);
+				const auto &diff = u.idht.mode.idm.colors.diff;
+				int r = (diff.R + diff.dR);
+				int g = (diff.G + diff.dG);
+				int b = (diff.B + diff.dB);
+
+				if (r < 0 || r > 31)
+				{
+					//DecodeTMode(dest, destRowPitch);
+				}
+				else if (g < 0 || g > 31)
+				{
+					//DecodeHMode(dest, destRowPitch);
+				}
+				else if (b < 0 || b > 31)
+				{
+					//DecodePlanarMode(dest, destRowPitch);
+				}
+				else
+				{
+					DecodeDifferentialMode(dest, destRowPitch, diff.R, diff.G, diff.B, r, g, b);
+				}
+			}
+			else
+			{
+				//DecodeIndividualMode(dest, destRowPitch);
+			}
+		}
+
+		void Decode(uint8* dest, uint32 destRowPitch) const
+		{
+			// Select mode
+			uint32 diff = (u.part0 >> 24) & 0x2;
+			if (diff)
+			{
+				int32  R = (u.part0 >> 3) & 0x1F;
+				int32 dR = ((int)(u.part0 & 0x7) << 29) >> 29;
+				int32  G = (u.part0 >> 11) & 0x1F;
+				int32 dG = ((int)((u.part0 >> 8) & 0x7) << 29) >> 29;
+				int32  B = (u.part0 >> 19) & 0x1F;
+				int32 dB = ((int)((u.part0 >> 16) & 0x7) << 29) >> 29;
+				int32 r = (R + dR);
+				int32 g = (G + dG);
+				int32 b = (B + dB);
+
+				if (r < 0 || r > 31)
+				{
+					DecodeTMode(dest, destRowPitch);
+				}
+				else if (g < 0 || g > 31)
+				{
+					DecodeHMode(dest, destRowPitch);
+				}
+				else if (b < 0 || b > 31)
+				{
+					DecodePlanarMode(dest, destRowPitch);
+				}
+				else
+				{
+					DecodeDifferentialMode(dest, destRowPitch, R, G, B, r, g, b);
+				}
+			}
+			else
+			{
+				DecodeIndividualMode(dest, destRowPitch);
+			}
+		}
+
+		enum Mode
+		{
+			ModeIndividual,
+			ModeDifferential,
+			ModeT,
+			ModeH,
+			ModePlanar,
+		};
+
+		Mode GetMode() const
+		{
+			return GetMode((u.part0 >> 25) & 0x1);
+		}
+
+		//RGB8A1 has no individual mode, its diff bit is the opaque bit and the mode is picked as if it was set
+		Mode GetPunchThroughMode() const
+		{
+			return GetMode(1);
+		}
+
+		bool IsOpaque() const { return ((u.part0 >> 25) & 0x1) != 0; }
+
+		//branch free, the mode follows from the diff bit and which of R + dR, G + dG, B + dB overflow
+		Mode GetMode(uint32 diff) const
+		{
+			static const uint8 modes[16] =
+			{
+				ModeIndividual, ModeDifferential, ModeIndividual, ModeT,
+				ModeIndividual, ModeH, ModeIndividual, ModeT,
+				ModeIndividual, ModePlanar, ModeIndividual, ModeT,
+				ModeIndividual, ModeH, ModeIndividual, ModeT,
+			};
+
+			int32 r = ((u.part0 >> 3) & 0x1F) + (((int)(u.part0 & 0x7) << 29) >> 29);
+			int32 g = ((u.part0 >> 11) & 0x1F) + (((int)((u.part0 >> 8) & 0x7) << 29) >> 29);
+			int32 b = ((u.part0 >> 19) & 0x1F) + (((int)((u.part0 >> 16) & 0x7) << 29) >> 29);
+			uint32 overflow = ((uint32)r > 31) << 1 | ((uint32)g > 31) << 2 | ((uint32)b > 31) << 3;
+			return (Mode)modes[diff | overflow];
+		}
+
+		//base colors of the two subblocks as 0xAABBGGRR, only valid in individual and differential mode
+		void GetSubblockBaseColors(uint32& color1, uint32& color2) const
+		{
+			if ((u.part0 >> 24) & 0x2)
+			{
+				GetDifferentialBaseColors(color1, color2);
+				return;
+			}
+
+			const auto &indiv = u.idht.mode.idm.colors.indiv;
+			color1 = extend_4to8bits(indiv.R1) | extend_4to8bits(indiv.G1) << 8 | extend_4to8bits(indiv.B1) << 16 | 0xFF000000;
+			color2 = extend_4to8bits(indiv.R2) | extend_4to8bits(indiv.G2) << 8 | extend_4to8bits(indiv.B2) << 16 | 0xFF000000;
+		}
+
+		//base colors of differential mode whatever the diff bit says, RGB8A1 blocks use it as the opaque bit
+		void GetDifferentialBaseColors(uint32& color1, uint32& color2) const
+		{
+			int32 R = (u.part0 >> 3) & 0x1F;
+			int32 G = (u.part0 >> 11) & 0x1F;
+			int32 B = (u.part0 >> 19) & 0x1F;
+			int32 r2 = extend_5to8bits(R + (((int)(u.part0 & 0x7) << 29) >> 29));
+			int32 g2 = extend_5to8bits(G + (((int)((u.part0 >> 8) & 0x7) << 29) >> 29));
+			int32 b2 = extend_5to8bits(B + (((int)((u.part0 >> 16) & 0x7) << 29) >> 29));
+			color1 = extend_5to8bits(R) | extend_5to8bits(G) << 8 | extend_5to8bits(B) << 16 | 0xFF000000;
+			color2 = r2 | g2 << 8 | b2 << 16 | 0xFF000000;
+		}
+
+		//the 16 index MSBs and LSBs, pixel (x, y) in bit x * 4 + y
+		void GetIndexBits(uint32& msb, uint32& lsb) const
+		{
+			msb = (u.part1 & 0xFF) << 8 | ((u.part1 >> 8) & 0xFF);
+			lsb = ((u.part1 >> 16) & 0xFF) << 8 | (u.part1 >> 24);
+		}
+
+		uint32 GetTableIndex1() const { return (u.part0 >> 29) & 0x7; }
+		uint32 GetTableIndex2() const { return (u.part0 >> 26) & 0x7; }
+		bool GetFlip() const { return ((u.part0 >> 24) & 0x1) != 0; }
+
+		void GetTModePaintColors(uint32 paintColors[4]) const
+		{
+			const auto &tm = u.idht.mode.tm;
+
+			int r1 = extend_4to8bits(tm.TR1a << 2 | tm.TR1b);
+			int g1 = extend_4to8bits(tm.TG1);
+			int b1 = extend_4to8bits(tm.TB1);
+			int r2 = extend_4to8bits(tm.TR2);
+			int g2 = extend_4to8bits(tm.TG2);
+			int b2 = extend_4to8bits(tm.TB2);
+
+			const int d = distanceTableTH[tm.Tda << 1 | tm.Tdb];
+
+			paintColors[0] = r1 | g1 << 8 | b1 << 16 | 0xFF000000;
+			paintColors[1] = ClampUint8Right(r2 + d) | ClampUint8Right(g2 + d) << 8 | ClampUint8Right(b2 + d) << 16 | 0xFF000000;
+			paintColors[2] = r2 | g2 << 8 | b2 << 16 | 0xFF000000;
+			paintColors[3] = ClampUint8Left(r2 - d) | ClampUint8Left(g2 - d) << 8 | ClampUint8Left(b2 - d) << 16 | 0xFF000000;
+		}
+
+		void GetHModePaintColors(uint32 paintColors[4]) const
+		{
+			const auto &hm = u.idht.mode.hm;
+
+			int r1 = extend_4to8bits(hm.HR1);
+			int g1 = extend_4to8bits(hm.HG1a << 1 | hm.HG1b);
+			int b1 = extend_4to8bits(hm.HB1a << 3 | hm.HB1b << 1 | hm.HB1c);
+			int r2 = extend_4to8bits(hm.HR2);
+			int g2 = extend_4to8bits(hm.HG2a << 1 | hm.HG2b);
+			int b2 = extend_4to8bits(hm.HB2);
+
+			const int orderingTrickBit =
+				((r1 << 16 | g1 << 8 | b1) >= (r2 << 16 | g2 << 8 | b2) ? 1 : 0);
+			const int d = distanceTableTH[(hm.Hda << 2) | (hm.Hdb << 1) | orderingTrickBit];
+
+			paintColors[0] = ClampUint8Right(r1 + d) | ClampUint8Right(g1 + d) << 8 | ClampUint8Right(b1 + d) << 16 | 0xFF000000;
+			paintColors[1] = ClampUint8Left(r1 - d) | ClampUint8Left(g1 - d) << 8 | ClampUint8Left(b1 - d) << 16 | 0xFF000000;
+			paintColors[2] = ClampUint8Right(r2 + d) | ClampUint8Right(g2 + d) << 8 | ClampUint8Right(b2 + d) << 16 | 0xFF000000;
+			paintColors[3] = ClampUint8Left(r2 - d) | ClampUint8Left(g2 - d) << 8 | ClampUint8Left(b2 - d) << 16 | 0xFF000000;
+		}
+
+		//origin, horizontal and vertical colors of planar mode, each as r, g, b
+		void GetPlanarColors(int32 o[3], int32 h[3], int32 v[3]) const
+		{
+			o[0] = extend_6to8bits(u.pblk.RO);
+			o[1] = extend_7to8bits(u.pblk.GO1 << 6 | u.pblk.GO2);
+			o[2] = extend_6to8bits(u.pblk.BO1 << 5 | u.pblk.BO2 << 3 | u.pblk.BO3a << 1 | u.pblk.BO3b);
+			h[0] = extend_6to8bits(u.pblk.RH1 << 1 | u.pblk.RH2);
+			h[1] = extend_7to8bits(u.pblk.GH);
+			h[2] = extend_6to8bits(u.pblk.BHa << 5 | u.pblk.BHb);
+			v[0] = extend_6to8bits(u.pblk.RVa << 3 | u.pblk.RVb);
+			v[1] = extend_7to8bits(u.pblk.GVa << 2 | u.pblk.GVb);
+			v[2] = extend_6to8bits(u.pblk.BV);
+		}
+
+		void DecodeIndividualMode(uint8* dest, uint32 destRowPitch) const
+		{
+			const auto &indiv = u.idht.mode.idm.colors.indiv;
+			int r1 = extend_4to8bits(indiv.R1);
+			int g1 = extend_4to8bits(indiv.G1);
+			int b1 = extend_4to8bits(indiv.B1);
+			int r2 = extend_4to8bits(indiv.R2);
+			int g2 = extend_4to8bits(indiv.G2);
+			int b2 = extend_4to8bits(indiv.B2);
+			DecodeIndividualOrDifferentialMode(dest, destRowPitch, r1, g1, b1, r2, g2, b2);
+		}
+
+		//void DecodeIndividualMode1(uint8* dest, uint32 destRowPitch) const
+		//{
+		//	int r1 = extend_4to8bits((u.part0 >> 4) & 0xF);
+		//	int r2 = extend_4to8bits(u.part0 & 0xF);
+		//	int g1 = extend_4to8bits((u.part0 >> 12) & 0xF);
+		//	int g2 = extend_4to8bits((u.part0 >> 8) & 0xF);
+		//	int b1 = extend_4to8bits((u.part0 >> 20) & 0xF);
+		//	int b2 = extend_4to8bits((u.part0 >> 16) & 0xF);
+		//	DecodeIndividualOrDifferentialMode(dest, destRowPitch, r1, g1, b1, r2, g2, b2);
+		//}
+
+		void DecodeDifferentialMode(uint8* dest, uint32 destRowPitch) const
+		{
+			int32 R = (u.part0 >> 3) & 0x1F;
+			int32 G = (u.part0 >> 11) & 0x1F;
+			int32 B = (u.part0 >> 19) & 0x1F;
+			int32 r = R + (((int)(u.part0 & 0x7) << 29) >> 29);
+			int32 g = G + (((int)((u.part0 >> 8) & 0x7) << 29) >> 29);
+			int32 b = B + (((int)((u.part0 >> 16) & 0x7) << 29) >> 29);
+			DecodeDifferentialMode(dest, destRowPitch, R, G, B, r, g, b);
+		}
+
+		inline void DecodeDifferentialMode(uint8* dest, uint32 destRowPitch, int R, int G, int B, int r, int g, int b) const
+		{
+			int r1 = extend_5to8bits(R);
+			int g1 = extend_5to8bits(G);
+			int b1 = extend_5to8bits(B);
+			int r2 = extend_5to8bits(r);
+			int g2 = extend_5to8bits(g);
+			int b2 = extend_5to8bits(b);
+			DecodeIndividualOrDifferentialMode(dest, destRowPitch, r1, g1, b1, r2, g2, b2);
+		}
+
+		//uint32 getIndex(uint32 x, uint32 y) const
+		//{
+		//	uint32 bitIndex = x * 4 + y;
+		//	uint32 bitOffset = bitIndex & 7;
+		//	uint32 lsb = (u.idht.pixelIndexLSB[1 - (bitIndex >> 3)] >> bitOffset) & 1;
+		//	uint32 msb = (u.idht.pixelIndexMSB[1 - (bitIndex >> 3)] >> bitOffset) & 1;
+		//	return (msb << 1) | lsb;
+		//}
+		inline uint32 getIndex(uint32 x, uint32 y) const
+		{
+			uint32 bitIndex = x * 4 + y;
+			uint32 bitOffset = bitIndex & 7;
+#ifdef __EMSCRIPTEN__
+			uint32 lsb = ((u.part1 >> (16 + 8 * (1 - (bitIndex >> 3)))) >> bitOffset) & 0x1;
+			uint32 msb = ((u.part1 >> (8 * (1 - (bitIndex >> 3)))) >> bitOffset) & 0x1;
+			return (msb << 1) | lsb;
+#else
+			uint32 lsb = (u.idht.pixelIndexLSB[1 - (bitIndex >> 3)] >> bitOffset) & 1;
+			uint32 msb = (u.idht.pixelIndexMSB[1 - (bitIndex >> 3)] >> bitOffset) & 1;
+			return (msb << 1) | lsb;
+#endif
+		}
+
+		//void DecodeIndividualOrDifferentialMode1(uint8* dest, uint32 destRowPitch, int r1, int g1, int b1, int r2, int g2, int b2) const
+		//{
+		//	static ColorRGBA8 subblockColors0[4];
+		//	static ColorRGBA8 subblockColors1[4];
+		//	for (uint32 modifierIdx = 0; modifierIdx < 4; modifierIdx++)
+		//	{
+		//		const int32 i1 = intensityModifierDefault[u.idht.mode.idm.cw1][modifierIdx];
+		//		ColorRGBA8& c0 = subblockColors0[modifierIdx];
+		//		c0.r = ClampUint8(r1 + i1);
+		//		c0.g = ClampUint8(g1 + i1);
+		//		c0.b = ClampUint8(b1 + i1);
+
+		//		const int32 i2 = intensityModifierDefault[u.idht.mode.idm.cw2][modifierIdx];
+		//		ColorRGBA8& c1 = subblockColors1[modifierIdx];
+		//		c1.r = ClampUint8(r2 + i2);
+		//		c1.g = ClampUint8(g2 + i2);
+		//		c1.b = ClampUint8(b2 + i2);
+		//	}
+
+		//	if (u.idht.mode.idm.flipbit)
+		//	{
+		//		//Two 4x2-pixel subblocks on top of each other
+		//		for (uint32 j = 0; j < 2; j++)
+		//		{
+		//			for (uint32 i = 0; i < 4; i++)
+		//			{
+		//				uint32 index = j * destRowPitch + i * 4;
+		//				*(uint32*)(dest + index) = subblockColors0[getIndex(i, j)].dwColor;
+		//			}
+		//		}
+		//		for (uint32 j = 2; j < 4; j++)
+		//		{
+		//			for (uint32 i = 0; i < 4; i++)
+		//			{
+		//				uint32 index = j * destRowPitch + i * 4;
+		//				*(uint32*)(dest + index) = subblockColors0[getIndex(i, j)].dwColor;
+		//			}
+		//		}
+		//	}
+		//	else
+		//	{
+		//		//Two 2x4-pixel subblocks side-by-side
+		//		for (uint32 j = 0; j < 4; j++)
+		//		{
+		//			for (uint32 i = 0; i < 2; i++)
+		//			{
+		//				uint32 index = j * destRowPitch + i * 4;
+		//				*(uint32*)(dest + index) = subblockColors0[getIndex(i, j)].dwColor;
+		//			}
+		//		}
+		//		for (uint32 j = 0; j < 4; j++)
+		//		{
+		//			for (uint32 i = 2; i < 4; i++)
+		//			{
+		//				uint32 index = j * destRowPitch + i * 4;
+		//				*(uint32*)(dest + index) = subblockColors0[getIndex(i, j)].dwColor;
+		//			}
+		//		}
+		//	}
+		//}
+
+		void DecodeIndividualOrDifferentialMode(uint8* dest, uint32 destRowPitch, int r1, int g1, int b1, int r2, int g2, int b2) const
+		{
+			//ColorRGBA8 subblockColors0[4];
+			//ColorRGBA8 subblockColors1[4];
+			//const auto tableIdx1 = u.idht.mode.idm.cw1;
+			//const auto tableIdx2 = u.idht.mode.idm.cw2;
+
+			uint32 subblockColors0[4];
+			uint32 subblockColors1[4];
+			uint32 tableIdx1 = (u.part0 >> 29) & 0x7;
+			uint32 tableIdx2 = (u.part0 >> 26) & 0x7;
+
+			for (uint32 modifierIdx = 0; modifierIdx < 4; modifierIdx++)
+			{
+				const int32 i1 = intensityModifierDefault[tableIdx1][modifierIdx];
+				//ColorRGBA8& c0 = subblockColors0[modifierIdx];
+				//c0.r = ClampUint8(r1 + i1);
+				//c0.g = ClampUint8(g1 + i1);
+				//c0.b = ClampUint8(b1 + i1);
+				//c0.dwColor = ClampUint8(r1 + i1) | (ClampUint8(g1 + i1) << 8) | (ClampUint8(b1 + i1) << 16) | 0xFF000000;
+				subblockColors0[modifierIdx] = ClampUint8(r1 + i1) | (ClampUint8(g1 + i1) << 8) | (ClampUint8(b1 + i1) << 16) | 0xFF000000;
+
+				const int32 i2 = intensityModifierDefault[tableIdx2][modifierIdx];
+				//ColorRGBA8& c1 = subblockColors1[modifierIdx];
+				//c1.r = ClampUint8(r2 + i2);
+				//c1.g = ClampUint8(g2 + i2);
+				//c1.b = ClampUint8(b2 + i2);
+				//c1.dwColor = ClampUint8(r2 + i2) | (ClampUint8(g2 + i2) << 8) | (ClampUint8(b2 + i2) << 16) | 0xFF000000;
+				subblockColors1[modifierIdx] = ClampUint8(r2 + i2) | (ClampUint8(g2 + i2) << 8) | (ClampUint8(b2 + i2) << 16) | 0xFF000000;
+			}
+
+			uint32 flip = (u.part0 >> 24) & 0x1;
+			if (flip)
+			{
+				//Two 4x2-pixel subblocks on top of each other
+				for (uint32 j = 0; j < 2; j++)
+				{
+					for (uint32 i = 0; i < 4; i++)
+					{
+						const uint32 destIndex = j * destRowPitch + i * 4;
+						*(uint32*)(dest + destIndex) = subblockColors0[getIndex(i, j)];
+					}
+				}
+				for (uint32 j = 2; j < 4; j++)
+				{
+					for (uint32 i = 0; i < 4; i++)
+					{
+						const uint32 destIndex = j * destRowPitch + i * 4;
+						*(uint32*)(dest + destIndex) = subblockColors1[getIndex(i, j)];
+					}
+				}
+			}
+			else
+			{
+				//Two 2x4-pixel subblocks side-by-side
+				for (uint32 j = 0; j < 4; j++)
+				{
+					for (uint32 i = 0; i < 2; i++)
+					{
+						const uint32 destIndex = j * destRowPitch + i * 4;
+						*(uint32*)(dest + destIndex) = subblockColors0[getIndex(i, j)];
+					}
+				}
+				for (uint32 j = 0; j < 4; j++)
+				{
+					for (uint32 i = 2; i < 4; i++)
+					{
+						const uint32 destIndex = j * destRowPitch + i * 4;
+						*(uint32*)(dest + destIndex) = subblockColors1[getIndex(i, j)];
+					}
+				}
+			}
+		}
+
+		void DecodeTMode(uint8* dest, uint32 destRowPitch) const
+		{
+			// Table C.8, distance index for T and H modes
+			const auto &tm = u.idht.mode.tm;
+
+			int r1 = extend_4to8bits(tm.TR1a << 2 | tm.TR1b);
+			int g1 = extend_4to8bits(tm.TG1);
+			int b1 = extend_4to8bits(tm.TB1);
+			int r2 = extend_4to8bits(tm.TR2);
+			int g2 = extend_4to8bits(tm.TG2);
+			int b2 = extend_4to8bits(tm.TB2);
+
+			const int d = distanceTableTH[tm.Tda << 1 | tm.Tdb];
+
+#ifdef __EMSCRIPTEN__
+			 uint32 paintColors[4] = {
+				r1 | g1<<8 | b1<<16 | 0xFF000000,
+				ClampUint8Right(r2 + d) | ClampUint8Right(g2 + d) << 8 | ClampUint8Right(b2 + d) << 16 | 0xFF000000,
+				r2 | g2 << 8 | b2 << 16 | 0xFF000000,
+				ClampUint8Left(r2 - d) | ClampUint8Left(g2 - d) << 8 | ClampUint8Left(b2 - d) << 16 | 0xFF000000,
+			};
+
+
+			for (uint32 j = 0; j < 4; j++)
+			{
+				for (uint32 i = 0; i < 4; i++)
+				{
+					uint32 destIndex = j * destRowPitch + i * 4;
+					*(uint32*)(dest+ destIndex) = paintColors[getIndex(i, j)];
+				}
+			}
+#else
+			 ColorRGBA8 paintColors[4] = {
+				ColorRGBA8(r1, g1, b1, 255),
+				ColorRGBA8(ClampUint8Right(r2 + d), ClampUint8Right(g2 + d), ClampUint8Right(b2 + d), 255),
+				ColorRGBA8(r2, g2, b2, 255),
+				ColorRGBA8(ClampUint8Left(r2 - d), ClampUint8Left(g2 - d), ClampUint8Left(b2 - d), 255),
+			};
+
+			for (uint32 j = 0; j < 4; j++)
+			{
+				for (uint32 i = 0; i < 4; i++)
+				{
+					uint32 destIndex = j * destRowPitch + i * 4;
+					*(uint32*)(dest+ destIndex) = paintColors[getIndex(i, j)].dwColor;
+				}
+			}
+#endif
+		}
+
+		void DecodeHMode(uint8* dest, uint32 destRowPitch) const
+		{
+			// Table C.8, distance index for T and H modes
+			const auto &hm = u.idht.mode.hm;
+
+			int r1 = extend_4to8bits(hm.HR1);
+			int g1 = extend_4to8bits(hm.HG1a << 1 | hm.HG1b);
+			int b1 = extend_4to8bits(hm.HB1a << 3 | hm.HB1b << 1 | hm.HB1c);
+			int r2 = extend_4to8bits(hm.HR2);
+			int g2 = extend_4to8bits(hm.HG2a << 1 | hm.HG2b);
+			int b2 = extend_4to8bits(hm.HB2);
+
+			const int orderingTrickBit =
+				((r1 << 16 | g1 << 8 | b1) >= (r2 << 16 | g2 << 8 | b2) ? 1 : 0);
+			const int d = distanceTableTH[(hm.Hda << 2) | (hm.Hdb << 1) | orderingTrickBit];
+
+#ifdef __EMSCRIPTEN__
+			uint32 paintColors[4] = {
+				ClampUint8Right(r1 + d) | ClampUint8Right(g1 + d) << 8 | ClampUint8Right(b1 + d) << 16 | 0xFF000000,
+				ClampUint8Left(r1 - d) | ClampUint8Left(g1 - d) << 8 | ClampUint8Left(b1 - d) << 16 | 0xFF000000,
+				ClampUint8Right(r2 + d) | ClampUint8Right(g2 + d) << 8 | ClampUint8Right(b2 + d) << 16 | 0xFF000000,
+				ClampUint8Left(r2 - d) | ClampUint8Left(g2 - d) << 8 | ClampUint8Left(b2 - d) << 16 | 0xFF000000,
+			};
+
+			for (uint32 j = 0; j < 4; j++)
+			{
+				for (uint32 i = 0; i < 4; i++)
+				{
+					uint32 destIndex = j * destRowPitch + i * 4;
+					*(uint32*)(dest + destIndex) = paintColors[getIndex(i, j)];
+				}
+			}
+#else
+			const ColorRGBA8 paintColors[4] = {
+				ColorRGBA8(ClampUint8Right(r1 + d), ClampUint8Right(g1 + d), ClampUint8Right(b1 + d), 255),
+				ColorRGBA8(ClampUint8Left(r1 - d), ClampUint8Left(g1 - d), ClampUint8Left(b1 - d), 255),
+				ColorRGBA8(ClampUint8Right(r2 + d), ClampUint8Right(g2 + d), ClampUint8Right(b2 + d), 255),
+				ColorRGBA8(ClampUint8Left(r2 - d), ClampUint8Left(g2 - d), ClampUint8Left(b2 - d), 255),
+			};
+
+			for (int j = 0; j < 4; j++)
+			{
+				for (int i = 0; i < 4; i++)
+				{
+					int index = j * destRowPitch + i * 4;
+					*(uint32*)(dest + index) = paintColors[getIndex(i, j)].dwColor;
+				}
+			}
+#endif
+		}
+
+		void DecodePlanarMode(uint8* dest, uint32 destRowPitch) const
+		{
+#ifdef __EMSCRIPTEN__
+			//need optimize
+			uint32 byte0 = u.part0 & 0xFF;
+			uint32 byte1 = (u.part0 >> 8) & 0xFF;
+			uint32 byte2 = (u.part0 >> 16) & 0xFF;
+			uint32 byte3 = (u.part0 >> 24) & 0xFF;
+			uint32 byte4 = u.part1 & 0xFF;
+			uint32 byte5 = (u.part1 >> 8) & 0xFF;
+			uint32 byte6 = (u.part1 >> 16) & 0xFF;
+			uint32 byte7 = (u.part1 >> 24) & 0xFF;
+			int ro = extend_6to8bits((byte0 >> 1) & 0x3F);
+			int gO1 = byte0 & 0x1;
+			int gO2 = (byte1 >> 1) & 0x3F;
+			int go = extend_7to8bits((gO1 << 6) | gO2);
+			int bO1 = byte1 & 0x1;
+			int bO2 = (byte2 >> 3) & 0x3;
+			int bO3 = ((byte2 & 0x3) << 1) | (byte3 >> 7);
+			int bo = extend_6to8bits(bO1 << 5 | bO2 << 3 | bO3);
+
+			int rH1 = (byte3 >> 2) & 0x1F;
+			int rH2 = byte3 & 0x1;
+			int rh = extend_6to8bits(rH1 << 1 | rH2);
+			int gh = extend_7to8bits(byte4 >> 1);
+			int bh = extend_6to8bits(((byte4 & 0x1) << 5) | (byte5 >> 3));
+
+			int rv = extend_6to8bits(((byte5 & 0x7) << 3) | (byte6 >> 5));
+			int gv = extend_7to8bits(((byte6 & 0x1F) << 2) | (byte7 >> 6));
+			int bv = extend_6to8bits(byte7 & 0x3F);
+#else
+			int ro = extend_6to8bits(u.pblk.RO);
+			int go = extend_7to8bits(u.pblk.GO1 << 6 | u.pblk.GO2);
+			int bo = extend_6to8bits(u.pblk.BO1 << 5 | u.pblk.BO2 << 3 | u.pblk.BO3a << 1 | u.pblk.BO3b);
+			int rh = extend_6to8bits(u.pblk.RH1 << 1 | u.pblk.RH2);
+			int gh = extend_7to8bits(u.pblk.GH);
+			int bh = extend_6to8bits(u.pblk.BHa << 5 | u.pblk.BHb);
+			int rv = extend_6to8bits(u.pblk.RVa << 3 | u.pblk.RVb);
+			int gv = extend_7to8bits(u.pblk.GVa << 2 | u.pblk.GVb);
+			int bv = extend_6to8bits(u.pblk.BV);
+#endif
+
+			int rvo = rv - ro;
+			int gvo = gv - go;
+			int bvo = bv - bo;
+
+			int rho = rh - ro;
+			int gho = gh - go;
+			int bho = bh - bo;
+
+			for (int j = 0; j < 4; j++)
+			{
+				int ry = j * rvo + 2;
+				int gy = j * gvo + 2;
+				int by = j * bvo + 2;
+
+				for (int i = 0; i < 4; i++)
+				{
+					int destIndex = j * destRowPitch + i * 4;
+#ifdef __EMSCRIPTEN__
+					uint32 r = ClampUint8(((i*rho + ry) >> 2) + ro);
+					uint32 g = ClampUint8(((i*gho + gy) >> 2) + go);
+					uint32 b = ClampUint8(((i*bho + by) >> 2) + bo);
+					*(uint32*)(dest + destIndex) = r | (g << 8) | (b << 16) | 0xFF000000;
+#else
+					ColorRGBA8& color = *(ColorRGBA8*)(dest + destIndex);
+					//color.r = ClampUint8((i*(rh - ro) + j * (rv - ro) + 2) >> 2 + ro);
+					//color.g = ClampUint8((i*(gh - go) + j * (gv - go) + 2) >> 2 + ro);
+					//color.b = ClampUint8((i*(bh - bo) + j * (bv - ro) + 2) >> 2 + ro);
+					color.r = ClampUint8(((i*rho + ry) >> 2) + ro);
+					color.g = ClampUint8(((i*gho + gy) >> 2) + go);
+					color.b = ClampUint8(((i*bho + by) >> 2) + bo);
+					color.a = 255;
+#endif
+				}
+			}
+		}
+
+		//RGB8A1 (Annex C.1.4): opaque and planar blocks decode like RGB8. Non-opaque differential blocks use
+		//intensityModifierNonOpaque, and index 2 is transparent black there and in non-opaque T and H blocks.
+		void DecodePunchThrough(uint8* dest, uint32 destRowPitch) const
+		{
+			const Mode mode = GetPunchThroughMode();
+			if (mode == ModePlanar)
+			{
+				DecodePlanarMode(dest, destRowPitch);
+				return;
+			}
+			if (IsOpaque())
+			{
+				if (mode == ModeT)
+					DecodeTMode(dest, destRowPitch);
+				else if (mode == ModeH)
+					DecodeHMode(dest, destRowPitch);
+				else
+					DecodeDifferentialMode(dest, destRowPitch);
+				return;
+			}
+
+			//pixel (x, y) uses palettes[(subblockBits >> (x * 4 + y)) & 1]
+			uint32 palettes[2][4];
+			uint32 subblockBits = 0;
+			if (mode == ModeT)
+			{
+				GetTModePaintColors(palettes[0]);
+			}
+			else if (mode == ModeH)
+			{
+				GetHModePaintColors(palettes[0]);
+			}
+			else
+			{
+				uint32 baseColors[2];
+				GetDifferentialBaseColors(baseColors[0], baseColors[1]);
+				const uint32 tableIdx[2] = { GetTableIndex1(), GetTableIndex2() };
+				for (uint32 s = 0; s < 2; s++)
+				{
+					for (uint32 m = 0; m < 4; m++)
+					{
+						const int32 modifier = intensityModifierNonOpaque[tableIdx[s]][m];
+						const uint32 c = baseColors[s];
+						palettes[s][m] = ClampUint8((int32)(c & 0xFF) + modifier) | ClampUint8((int32)((c >> 8) & 0xFF) + modifier) << 8 | ClampUint8((int32)((c >> 16) & 0xFF) + modifier) << 16 | 0xFF000000;
+					}
+				}
+				subblockBits = GetFlip() ? 0xCCCC : 0xFF00;
+			}
+			palettes[0][2] = 0;
+			palettes[1][2] = 0;
+
+			uint32 msb, lsb;
+			GetIndexBits(msb, lsb);
+			for (uint32 j = 0; j < 4; j++)
+			{
+				for (uint32 i = 0; i < 4; i++)
+				{
+					const uint32 k = i * 4 + j;
+					const uint32 index = ((msb >> k) & 1) << 1 | ((lsb >> k) & 1);
+					*(uint32*)(dest + j * destRowPitch + i * 4) = palettes[(subblockBits >> k) & 1][index];
+				}
+			}
+		}
+	};
+
+	//The colors an ETC2 block can produce and the entry every pixel uses (row-major).
+	//The BC transcoders and the 16 bit decoders work per entry, at most 8 of them except for planar blocks.
+	struct BlockPalette
+	{
+		uint32 colors[16];
+		uint32 count;
+		uint8 entries[16];
+	};
+
+	static inline uint32 AddModifier(uint32 color, int32 modifier)
+	{
+		return ClampUint8((int32)(color & 0xFF) + modifier) | ClampUint8((int32)((color >> 8) & 0xFF) + modifier) << 8 | ClampUint8((int32)((color >> 16) & 0xFF) + modifier) << 16 | 0xFF000000;
+	}
+
+	//punchThrough reads an RGB8A1 block, see ETC2Block::DecodePunchThrough; its transparent entries are 0
+	template<bool punchThrough>
+	static inline void GetETC2Palette(const ETC2Block* block, BlockPalette& palette)
+	{
+		const ETC2Block::Mode mode = punchThrough ? block->GetPunchThroughMode() : block->GetMode();
+		if (mode == ETC2Block::ModePlanar)
+		{
+			//a gradient, every pixel is its own entry
+			block->DecodePlanarMode((uint8*)palette.colors, 16);
+			palette.count = 16;
+			for (uint32 k = 0; k < 16; ++k)
+				palette.entries[k] = (uint8)k;
+			return;
+		}
+
+		//entry of pixel (x, y) before the subblock is added, k = x * 4 + y
+		const bool nonOpaque = punchThrough && !block->IsOpaque();
+		uint32 msb, lsb;
+		block->GetIndexBits(msb, lsb);
+		uint32 subblockBits = 0;
+		if (mode == ETC2Block::ModeT || mode == ETC2Block::ModeH)
+		{
+			if (mode == ETC2Block::ModeT)
+				block->GetTModePaintColors(palette.colors);
+			else
+				block->GetHModePaintColors(palette.colors);
+			palette.count = 4;
+			if (nonOpaque)
+				palette.colors[2] = 0;
+		}
+		else
+		{
+			uint32 baseColors[2];
+			if (punchThrough)
+				block->GetDifferentialBaseColors(baseColors[0], baseColors[1]);
+			else
+				block->GetSubblockBaseColors(baseColors[0], baseColors[1]);
+			const int32 (*modifiers)[4] = nonOpaque ? intensityModifierNonOpaque : intensityModifierDefault;
+			const int32* modifiers1 = modifiers[block->GetTableIndex1()];
+			const int32* modifiers2 = modifiers[block->GetTableIndex2()];
+			for (uint32 m = 0; m < 4; ++m)
+			{
+				palette.colors[m] = AddModifier(baseColors[0], modifiers1[m]);
+				palette.colors[4 + m] = AddModifier(baseColors[1], modifiers2[m]);
+			}
+			palette.count = 8;
+			if (nonOpaque)
+			{
+				palette.colors[2] = 0;
+				palette.colors[6] = 0;
+			}
+
+			//second subblock: the right half (x >= 2), or the bottom half (y >= 2) when flipped
+			subblockBits = block->GetFlip() ? 0xCCCC : 0xFF00;
+		}
+
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			const uint32 entry = ((subblockBits >> k) & 1) << 2 | ((msb >> k) & 1) << 1 | ((lsb >> k) & 1);
+			palette.entries[(k & 3) * 4 + (k >> 2)] = (uint8)entry;
+		}
+	}
+
+	//Weighted mean of count colors (0xAABBGGRR), 0 when every weight is 0
+	static inline void GetMeanColor(const uint32* colors, const uint32* weights, uint32 count, int32 mean[3])
+	{
+		uint32 sum[3] = { 0, 0, 0 };
+		uint32 total = 0;
+		for (uint32 e = 0; e < count; ++e)
+		{
+			for (uint32 c = 0; c < 3; ++c)
+				sum[c] += weights[e] * ((colors[e] >> (c * 8)) & 0xFF);
+			total += weights[e];
+		}
+		for (uint32 c = 0; c < 3; ++c)
+			mean[c] = total ? (int32)((sum[c] + total / 2) / total) : 0;
+	}
+
+	//Quantize the means of the two subblocks to the 5 bit colors of a differential block when their difference fits
+	//in 3 bits, to the 4 bit colors of an individual block otherwise. Returns true for differential,
+	//color1 and color2 receive the decoded base colors.
+	static inline bool QuantizeETC1BaseColors(const int32 mean1[3], const int32 mean2[3], int32 base1[3], int32 base2[3], uint32& color1, uint32& color2)
+	{
+		bool differential = true;
+		for (uint32 c = 0; c < 3; ++c)
+		{
+			base1[c] = (mean1[c] * 31 + 127) / 255;
+			base2[c] = (mean2[c] * 31 + 127) / 255;
+			differential = differential && base2[c] - base1[c] >= -4 && base2[c] - base1[c] <= 3;
+		}
+
+		color1 = color2 = 0xFF000000;
+		for (uint32 c = 0; c < 3; ++c)
+		{
+			if (!differential)
+			{
+				base1[c] = (mean1[c] * 15 + 127) / 255;
+				base2[c] = (mean2[c] * 15 + 127) / 255;
+			}
+			color1 |= (differential ? extend_5to8bits(base1[c]) : extend_4to8bits(base1[c])) << (c * 8);
+			color2 |= (differential ? extend_5to8bits(base2[c]) : extend_4to8bits(base2[c])) << (c * 8);
+		}
+		return differential;
+	}
+
+	//One ETC1 subblock fitted to weighted colors: selectors[e] is the index (msb << 1 | lsb) color e takes
+	struct ETC1SubblockFit
+	{
+		uint32 table;
+		uint32 error;
+		uint8 selectors[16];
+	};
+
+	//Every color takes the modifier closest to it and the table with the smallest weighted squared error wins.
+	//Only the two modifiers on the side of the color's mean offset from the base are tried, the other side is
+	//further away unless clamping interferes. Colors without weight take selector 0.
+	static inline void FitETC1Subblock(uint32 baseColor, const uint32* colors, const uint32* weights, uint32 count, ETC1SubblockFit& fit)
+	{
+		int32 base[3];
+		for (uint32 c = 0; c < 3; ++c)
+			base[c] = (baseColor >> (c * 8)) & 0xFF;
+		const int32 baseMin = (int32)Min(Min(base[0], base[1]), base[2]);
+		const int32 baseMax = (int32)Max(Max(base[0], base[1]), base[2]);
+
+		//the used colors with the absolute sum and the sum of squares of their offsets from the base, and the
+		//selector offset of their side: 0 above the base and 2 below it
+		int32 used[16][3];
+		int32 offsetSums[16];
+		int32 offsetSquares[16];
+		uint32 usedWeights[16];
+		uint8 usedEntries[16];
+		uint8 sides[16];
+		uint32 usedCount = 0;
+		for (uint32 e = 0; e < count; ++e)
+		{
+			fit.selectors[e] = 0;
+			if (weights[e] == 0)
+				continue;
+			int32 sum = 0, squares = 0;
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				used[usedCount][c] = (colors[e] >> (c * 8)) & 0xFF;
+				const int32 offset = used[usedCount][c] - base[c];
+				sum += offset;
+				squares += offset * offset;
+			}
+			offsetSums[usedCount] = sum < 0 ? -sum : sum;
+			offsetSquares[usedCount] = squares;
+			usedWeights[usedCount] = weights[e];
+			usedEntries[usedCount] = (uint8)e;
+			sides[usedCount] = sum < 0 ? 2 : 0;
+			++usedCount;
+		}
+
+		fit.table = 0;
+		fit.error = usedCount ? 0xFFFFFFFF : 0;
+		uint8 selectors[16];
+		for (uint32 t = 0; t < 8 && fit.error; ++t)
+		{
+			const int32* modifiers = intensityModifierDefault[t];
+			uint32 error = 0;
+			if (baseMin - modifiers[1] >= 0 && baseMax + modifiers[1] <= 255)
+			{
+				//no clamping, the distance to base +- modifier is squares - 2 * modifier * |sum| + 3 * modifier^2
+				for (uint32 u = 0; u < usedCount; ++u)
+				{
+					const uint32 distance0 = (uint32)(offsetSquares[u] + modifiers[0] * (3 * modifiers[0] - 2 * offsetSums[u]));
+					const uint32 distance1 = (uint32)(offsetSquares[u] + modifiers[1] * (3 * modifiers[1] - 2 * offsetSums[u]));
+					const uint32 m = distance1 < distance0;
+					selectors[u] = (uint8)(sides[u] + m);
+					error += usedWeights[u] * (m ? distance1 : distance0);
+				}
+			}
+			else
+			{
+				int32 palette[4][3];
+				for (uint32 m = 0; m < 4; ++m)
+				{
+					for (uint32 c = 0; c < 3; ++c)
+						palette[m][c] = ClampUint8(base[c] + modifiers[m]);
+				}
+				for (uint32 u = 0; u < usedCount; ++u)
+				{
+					const int32* palette0 = palette[sides[u]];
+					const int32* palette1 = palette[sides[u] + 1];
+					uint32 distance0 = 0, distance1 = 0;
+					for (uint32 c = 0; c < 3; ++c)
+					{
+						const int32 d0 = palette0[c] - used[u][c];
+						const int32 d1 = palette1[c] - used[u][c];
+						distance0 += d0 * d0;
+						distance1 += d1 * d1;
+					}
+					const uint32 m = distance1 < distance0;
+					selectors[u] = (uint8)(sides[u] + m);
+					error += usedWeights[u] * (m ? distance1 : distance0);
+				}
+			}
+
+			if (error < fit.error)
+			{
+				fit.table = t;
+				fit.error = error;
+				for (uint32 u = 0; u < usedCount; ++u)
+					fit.selectors[usedEntries[u]] = selectors[u];
+			}
+		}
+	}
+
+	//Write an ETC1 block, base1 and base2 are the 5 bit colors of a differential block or the 4 bit colors of an
+	//individual one. selectors[k] is the index of pixel (x, y), k = x * 4 + y.
+	static inline void WriteETC1Block(uint8* dest, bool differential, bool flip, const int32 base1[3], const int32 base2[3], uint32 table1, uint32 table2, const uint8 selectors[16])
+	{
+		for (uint32 c = 0; c < 3; ++c)
+			dest[c] = (uint8)(differential ? base1[c] << 3 | ((base2[c] - base1[c]) & 0x7) : base1[c] << 4 | base2[c]);
+		dest[3] = (uint8)(table1 << 5 | table2 << 2 | (differential ? 2 : 0) | (flip ? 1 : 0));
+
+		uint32 msb = 0, lsb = 0;
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			msb |= (selectors[k] >> 1) << k;
+			lsb |= (selectors[k] & 1) << k;
+		}
+		dest[4] = (uint8)(msb >> 8);
+		dest[5] = (uint8)msb;
+		dest[6] = (uint8)(lsb >> 8);
+		dest[7] = (uint8)lsb;
+	}
+
+	//Table C.10: Intensity modifier sets for alpha component.
+	static const int32 intensityModifierAlpha[16][8] =
+	{
+		{ -3, -6,  -9, -15, 2, 5, 8, 14 },
+		{ -3, -7, -10, -13, 2, 6, 9, 12 },
+		{ -2, -5,  -8, -13, 1, 4, 7, 12 },
+		{ -2, -4,  -6, -13, 1, 3, 5, 12 },
+		{ -3, -6,  -8, -12, 2, 5, 7, 11 },
+		{ -3, -7,  -9, -11, 2, 6, 8, 10 },
+		{ -4, -7,  -8, -11, 3, 6, 7, 10 },
+		{ -3, -5,  -8, -11, 2, 4, 7, 10 },
+		{ -2, -6,  -8, -10, 1, 5, 7,  9 },
+		{ -2, -5,  -8, -10, 1, 4, 7,  9 },
+		{ -2, -4,  -8, -10, 1, 3, 7,  9 },
+		{ -2, -5,  -7, -10, 1, 4, 6,  9 },
+		{ -3, -4,  -7, -10, 2, 3, 6,  9 },
+		{ -1, -2,  -3, -10, 0, 1, 2,  9 },
+		{ -4, -6,  -8,  -9, 3, 5, 7,  8 },
+		{ -3, -5,  -7,  -9, 2, 4, 6,  8 }
+	};
+
+	class EACBlock
+	{
+	private:
+		uint32 part0;
+		uint32 part1;
+	public:
+		void Decode(uint8* dest, uint32 destRowPitch) const
+		{
+			//	uint8 base_codeword : 8;
+			//	uint8 table_index : 4;
+			//	uint8 multiplier : 4;
+			//	uint8 mc1 : 2; 16
+			//	uint8 mb : 3;  18
+			//	uint8 ma : 3;  21
+			//	uint8 mf1 : 1; 24
+			//	uint8 me : 3;  25
+			//	uint8 md : 3;  28
+			//	uint8 mc2 : 1; 31
+			//	uint8 mh : 3;  0
+			//	uint8 mg : 3;  3
+			//	uint8 mf2 : 2; 6
+			//	uint8 mk1 : 2; 8
+			//	uint8 mj : 3;  10
+			//	uint8 mi : 3;  13
+			//	uint8 mn1 : 1; 16
+			//	uint8 mm : 3;  17
+			//	uint8 ml : 3;  20
+			//	uint8 mk2 : 1; 23
+			//	uint8 mp : 3;  24
+			//	uint8 mo : 3;  27
+			//	uint8 mn2 : 2; 30
+			uint8 alphas[8];
+			GetAlphas(alphas);
+
+			const uint64 indexBits = GetIndexBits();
+			for (uint32 j = 0; j < 4; j++)
+			{
+				for (uint32 i = 0; i < 4; i++)
+				{
+					const uint32 destIndex = j * destRowPitch + i * 4;
+					dest[destIndex + 3] = alphas[GetIndex(indexBits, i, j)];
+				}
+			}
+		}
+
+		//R11/RG11 channel, 0..2047 or -1023..1023 when isSigned, one value per pixel in row-major order
+		template<bool isSigned>
+		void DecodeChannel11(int32 values[16]) const
+		{
+			int32 base;
+			if (isSigned)
+			{
+				//-128 is not a valid signed base codeword and is treated as -127
+				base = ((int32)(part0 << 24)) >> 24;
+				if (base == -128)
+					base = -127;
+				base = base * 8;
+			}
+			else
+			{
+				base = GetBaseCodeword() * 8 + 4;
+			}
+
+			const int32 multiplier = GetMultiplier();
+			const int32 scale = multiplier == 0 ? 1 : multiplier * 8;
+			const int32* modifiers = intensityModifierAlpha[GetTableIndex()];
+
+			int32 channels[8];
+			for (uint32 k = 0; k < 8; k++)
+				channels[k] = isSigned ? Clamp(base + modifiers[k] * scale, -1023, 1023) : Clamp(base + modifiers[k] * scale, 0, 2047);
+
+			const uint64 indexBits = GetIndexBits();
+			for (uint32 j = 0; j < 4; j++)
+			{
+				for (uint32 i = 0; i < 4; i++)
+					values[j * 4 + i] = channels[GetIndex(indexBits, i, j)];
+			}
+		}
+
+		//the 8 alpha values selected by the pixel indices
+		void GetAlphas(uint8 alphas[8]) const
+		{
+			const int32 base_codeword = GetBaseCodeword();
+			const int32 multiplier = GetMultiplier();
+			const int32* modifiers = intensityModifierAlpha[GetTableIndex()];
+
+			for (uint32 k = 0; k < 8; k++)
+				alphas[k] = ClampUint8(base_codeword + multiplier * modifiers[k]);
+		}
+
+		int32 GetBaseCodeword() const { return part0 & 0xFF; }
+		int32 GetMultiplier() const { return (part0 >> 12) & 0xF; }
+		uint32 GetTableIndex() const { return (part0 >> 8) & 0xF; }
+
+		//the 48 index bits of bytes 2..7 as one big-endian number, pixel a in bits 47..45 down to pixel p in bits 2..0
+		uint64 GetIndexBits() const
+		{
+			const uint32 hi = ((part0 >> 8) & 0xFF00) | (part0 >> 24);
+			const uint32 lo = (part1 << 24) | ((part1 << 8) & 0xFF0000) | ((part1 >> 8) & 0xFF00) | (part1 >> 24);
+			return (uint64)hi << 32 | lo;
+		}
+
+		static inline uint32 GetIndex(uint64 indexBits, uint32 x, uint32 y)
+		{
+			return (uint32)(indexBits >> (45 - 3 * (x * 4 + y))) & 0x7;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+#include "BaseType.h"
+namespace TT
+{
+	//Decode blockCount horizontally adjacent 4x4 blocks into dest, each block advances dest by 4 pixels
+	typedef void (*DecodeRowFunc)(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+
+	//Decode the blocks blockIndices[0..count) of one block row, all of them ETC2 blocks in the given ETC2Block::Mode.
+	//blockSize 8 is ETC2 RGB, blockSize 16 is ETC2_EAC with the EAC half first.
+	typedef void (*DecodeModeRunFunc)(uint32 mode, const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count);
+
+	//Transcode blockCount consecutive blocks into as many blocks of another format
+	typedef void (*TranscodeBlocksFunc)(const uint8* source, uint8* dest, uint32 blockCount);
+
+	//Encode blockCount horizontally adjacent 4x4 blocks of RGBA8 pixels, rows sourceRowPitch bytes apart, each block advances source by 4 pixels
+	typedef void (*EncodeRowFunc)(const uint8* source, uint32 sourceRowPitch, uint8* dest, uint32 blockCount);
+
+	//Entry of decodeEACChannelRows for signed or unsigned R11 (channels = 1) or RG11 (channels = 2) into 16 or 8 bits per channel
+	inline uint32 GetEACChannelRowIndex(bool isSigned, uint32 channels, bool is16Bits)
+	{
+		return (isSigned ? 4 : 0) + (channels - 1) * 2 + (is16Bits ? 1 : 0);
+	}
+
+	//Decode a whole width x height image with decodeRow into rows width * pixelSize bytes apart, edge blocks are clipped
+	void TranscodeImageRows(DecodeRowFunc decodeRow, uint32 blockSize, const uint8* source, uint8* dest, uint32 width, uint32 height, uint32 pixelSize = 4);
+
+	//Decode block rows [byBegin, byEnd) of a width x height image, source points at block row byBegin and dest at its first pixel row
+	void TranscodeBlockRows(DecodeRowFunc decodeRow, uint32 blockSize, const uint8* source, uint8* dest, uint32 destRowPitch, uint32 width, uint32 height, uint32 byBegin, uint32 byEnd);
+
+	namespace Scalar
+	{
+		void DecodeETC2Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeETC2A1Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeETC2EACRow(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeETC2ModeRun(uint32 mode, const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count);
+		void TranscodeETC2ToBC1Blocks(const uint8* source, uint8* dest, uint32 blockCount);
+		void TranscodeETC2EACToBC3Blocks(const uint8* source, uint8* dest, uint32 blockCount);
+		void TranscodeETC2ToATCBlocks(const uint8* source, uint8* dest, uint32 blockCount);
+		void TranscodeETC2EACToATCBlocks(const uint8* source, uint8* dest, uint32 blockCount);
+		void DecodeBC1Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeBC3Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void TranscodeBC1ToETC1Blocks(const uint8* source, uint8* dest, uint32 blockCount);
+		extern const DecodeRowFunc decodeEACChannelRows[8];
+		void EncodeETC1FastRow(const uint8* source, uint32 sourceRowPitch, uint8* dest, uint32 blockCount);
+	}
+
+#if TT_SSE41
+	namespace SSE41
+	{
+		void DecodeETC2Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeETC2A1Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeETC2EACRow(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeETC2ModeRun(uint32 mode, const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count);
+		void TranscodeETC2ToBC1Blocks(const uint8* source, uint8* dest, uint32 blockCount);
+		void TranscodeETC2EACToBC3Blocks(const uint8* source, uint8* dest, uint32 blockCount);
+		void TranscodeETC2ToATCBlocks(const uint8* source, uint8* dest, uint32 blockCount);
+		void TranscodeETC2EACToATCBlocks(const uint8* source, uint8* dest, uint32 blockCount);
+		void DecodeBC1Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeBC3Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void TranscodeBC1ToETC1Blocks(const uint8* source, uint8* dest, uint32 blockCount);
+		extern const DecodeRowFunc decodeEACChannelRows[8];
+		void EncodeETC1FastRow(const uint8* source, uint32 sourceRowPitch, uint8* dest, uint32 blockCount);
+	}
+#endif
+
+#if TT_SIMD128
+	namespace SIMD128
+	{
+		void DecodeETC2Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeETC2A1Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeETC2EACRow(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount);
+		void DecodeETC2ModeRun(uint32 mode, const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count);
+		extern const DecodeRowFunc decodeEACChannelRows[8];
+	}
+#endif
+
+	//The kernels of one instruction set
+	struct KernelTable
+	{
+		uint32 isa; //TTKernelISA
+		DecodeRowFunc decodeETC2Row;
+		DecodeRowFunc decodeETC2A1Row;
+		DecodeRowFunc decodeETC2EACRow;
+		DecodeModeRunFunc decodeETC2ModeRun;
+		const DecodeRowFunc* decodeEACChannelRows; //R11 and RG11, 8 entries indexed by GetEACChannelRowIndex
+		TranscodeBlocksFunc transcodeETC2ToBC1Blocks;
+		TranscodeBlocksFunc transcodeETC2EACToBC3Blocks;
+		TranscodeBlocksFunc transcodeETC2ToATCBlocks;
+		TranscodeBlocksFunc transcodeETC2EACToATCBlocks;
+		DecodeRowFunc decodeBC1Row;
+		DecodeRowFunc decodeBC3Row;
+		TranscodeBlocksFunc transcodeBC1ToETC1Blocks;
+		EncodeRowFunc encodeETC1FastRow;
+	};
+
+	//The best table for this CPU, picked on first use, or the one forced by TTSetKernelISA
+	const KernelTable& GetKernels();
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "ETC.h"
+#include "ETCBlock.h"
+#include "ETCKernel.h"
+#include "Stats.h"
+namespace TT
+{
+	//4x4 Bayer matrix as QuantizeChannel thresholds, (b * 2 + 1) * 255 / 32, row-major
+	static const uint8 ditherThresholds[16] =
+	{
+		7, 135, 39, 167,
+		199, 71, 231, 103,
+		55, 183, 23, 151,
+		247, 119, 215, 87,
+	};
+
+	namespace Scalar
+	{
+		//Color is ColorRGB565, ColorRGBA4 or ColorRGBA5551. Alpha comes from the EAC block when withEAC, from the palette otherwise.
+		//The block palette is packed once and looked up per pixel, dithering quantizes every pixel with its own threshold instead.
+		template<typename Color, bool withEAC, bool punchThrough, bool dither>
+		static void DecodeETC2Row16(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				BlockPalette palette;
+				GetETC2Palette<punchThrough>((const ETC2Block*)(withEAC ? source + 8 : source), palette);
+
+				uint32 packedColors[16];
+				if (!dither)
+				{
+					for (uint32 e = 0; e < palette.count; ++e)
+						packedColors[e] = Color::PackRGB(palette.colors[e], 127) | (withEAC ? 0 : Color::PackAlpha(palette.colors[e] >> 24));
+				}
+
+				uint32 packedAlphas[8];
+				uint64 alphaIndexBits = 0;
+				if (withEAC)
+				{
+					const EACBlock* eac = (const EACBlock*)source;
+					uint8 alphas[8];
+					eac->GetAlphas(alphas);
+					for (uint32 e = 0; e < 8; ++e)
+						packedAlphas[e] = Color::PackAlpha(alphas[e]);
+					alphaIndexBits = eac->GetIndexBits();
+				}
+
+				for (uint32 y = 0; y < 4; y++)
+				{
+					uint16* row = (uint16*)(dest + y * destRowPitch);
+					for (uint32 x = 0; x < 4; x++)
+					{
+						const uint32 k = y * 4 + x;
+						uint32 value;
+						if (dither)
+						{
+							const uint32 color = palette.colors[palette.entries[k]];
+							value = Color::PackRGB(color, ditherThresholds[k]) | (withEAC ? 0 : Color::PackAlpha(color >> 24));
+						}
+						else
+						{
+							value = packedColors[palette.entries[k]];
+						}
+						if (withEAC)
+							value |= packedAlphas[EACBlock::GetIndex(alphaIndexBits, x, y)];
+						row[x] = (uint16)value;
+					}
+				}
+
+				source += withEAC ? 16 : 8;
+				dest += 8;
+			}
+		}
+	}
+
+	void TranscodeETC2_to_RGB565(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 dither)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, (uint64)width * height * 2);
+		TranscodeImageRows(dither ? Scalar::DecodeETC2Row16<ColorRGB565, false, false, true> : Scalar::DecodeETC2Row16<ColorRGB565, false, false, false>, 8, source, dest, width, height, 2);
+	}
+
+	void TranscodeETC2_A1_to_RGBA5551(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 dither)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2A1, source, width, height, (uint64)width * height * 2);
+		TranscodeImageRows(dither ? Scalar::DecodeETC2Row16<ColorRGBA5551, false, true, true> : Scalar::DecodeETC2Row16<ColorRGBA5551, false, true, false>, 8, source, dest, width, height, 2);
+	}
+
+	void TranscodeETC2_EAC_to_RGBA4444(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 dither)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, (uint64)width * height * 2);
+		TranscodeImageRows(dither ? Scalar::DecodeETC2Row16<ColorRGBA4, true, false, true> : Scalar::DecodeETC2Row16<ColorRGBA4, true, false, false>, 16, source, dest, width, height, 2);
+	}
+
+	void TranscodeETC2_EAC_to_RGBA5551(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 dither)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, (uint64)width * height * 2);
+		TranscodeImageRows(dither ? Scalar::DecodeETC2Row16<ColorRGBA5551, true, false, true> : Scalar::DecodeETC2Row16<ColorRGBA5551, true, false, false>, 16, source, dest, width, height, 2);
+	}
+}
\ No newline at end of file
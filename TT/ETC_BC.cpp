@@ -0,0 +1,224 @@
+#include "ETC.h"
+#include "ETCBlock.h"
+#include "BCBlock.h"
+#include "ETCKernel.h"
+#include "Stats.h"
+namespace TT
+{
+	//Endpoints are the two pixels furthest apart along the bounding box diagonal (GetBC1Axis), each palette entry then
+	//takes the block color closest to it along the endpoint line and the pixels inherit it. SSE41::EncodeColorBlock
+	//makes the same choices on the decoded pixels.
+	template<uint32 format>
+	static void EncodeColorBlock(const BlockPalette& palette, BC1Block& block)
+	{
+		uint32 weights[16] = {};
+		for (uint32 k = 0; k < 16; ++k)
+			++weights[palette.entries[k]];
+
+		int32 colors[16][3];
+		int32 minColor[3] = { 255, 255, 255 };
+		int32 maxColor[3] = { 0, 0, 0 };
+		int32 sum[3] = { 0, 0, 0 };
+		for (uint32 e = 0; e < palette.count; ++e)
+		{
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				const int32 value = (palette.colors[e] >> (c * 8)) & 0xFF;
+				colors[e][c] = value;
+				sum[c] += weights[e] * value;
+				if (weights[e])
+				{
+					minColor[c] = value < minColor[c] ? value : minColor[c];
+					maxColor[c] = value > maxColor[c] ? value : maxColor[c];
+				}
+			}
+		}
+
+		int32 start[3], direction[3];
+		const int32 extent[3] = { maxColor[0] - minColor[0], maxColor[1] - minColor[1], maxColor[2] - minColor[2] };
+		if ((extent[0] | extent[1] | extent[2]) == 0)
+		{
+			const uint32 color = palette.colors[palette.entries[0]];
+			SetColorEndpoints<format>(color, color, block, start, direction);
+			return;
+		}
+
+		const uint32 widest = GetWidestChannel(extent);
+		int32 crossSums[3] = { 0, 0, 0 };
+		for (uint32 e = 0; e < palette.count; ++e)
+		{
+			for (uint32 c = 0; c < 3; ++c)
+				crossSums[c] += weights[e] * colors[e][widest] * colors[e][c];
+		}
+		for (uint32 c = 0; c < 3; ++c)
+			crossSums[c] = 16 * crossSums[c] - sum[widest] * sum[c];
+
+		int32 axis[3];
+		GetBC1Axis(extent, crossSums, axis);
+
+		int32 projections[16];
+		for (uint32 e = 0; e < palette.count; ++e)
+			projections[e] = colors[e][0] * axis[0] + colors[e][1] * axis[1] + colors[e][2] * axis[2];
+
+		//first pixel with the smallest and the largest projection
+		uint32 minEntry = palette.entries[0];
+		uint32 maxEntry = palette.entries[0];
+		for (uint32 k = 1; k < 16; ++k)
+		{
+			const uint32 e = palette.entries[k];
+			minEntry = projections[e] < projections[minEntry] ? e : minEntry;
+			maxEntry = projections[e] > projections[maxEntry] ? e : maxEntry;
+		}
+
+		if (!SetColorEndpoints<format>(palette.colors[maxEntry], palette.colors[minEntry], block, start, direction))
+			return;
+
+		//project on the line from color1 to color0 and count the midpoints passed
+		const ColorBlockSteps& steps = colorBlockSteps[format];
+		const int32 length2 = direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2];
+		const int32 threshold0 = steps.thresholds[0] * length2;
+		const int32 threshold1 = steps.thresholds[1] * length2;
+		const int32 threshold2 = steps.thresholds[2] * length2;
+
+		uint32 entryIndices[16];
+		for (uint32 e = 0; e < palette.count; ++e)
+		{
+			const int32 t = steps.scale * ((colors[e][0] - start[0]) * direction[0] + (colors[e][1] - start[1]) * direction[1] + (colors[e][2] - start[2]) * direction[2]);
+			entryIndices[e] = steps.stepToIndex[(t > threshold0) + (t > threshold1) + (t > threshold2)];
+		}
+
+		uint32 indices = 0;
+		for (uint32 k = 0; k < 16; ++k)
+			indices |= entryIndices[palette.entries[k]] << (k * 2);
+		block.indices = indices;
+	}
+
+	//The EAC alpha palette is re-quantized between its smallest and largest used value, blocks with
+	//at most two used values stay exact
+	static void EncodeBC3AlphaBlock(const EACBlock* eac, BC3AlphaBlock& bc3)
+	{
+		uint8 alphas[8];
+		eac->GetAlphas(alphas);
+
+		const uint64 eacIndexBits = eac->GetIndexBits();
+		uint32 entries[16];
+		uint32 used = 0;
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			//k = x * 4 + y counts down from bit 45
+			const uint32 entry = (uint32)(eacIndexBits >> (45 - 3 * k)) & 0x7;
+			entries[(k & 3) * 4 + (k >> 2)] = entry;
+			used |= 1 << entry;
+		}
+
+		uint32 minAlpha = 255;
+		uint32 maxAlpha = 0;
+		for (uint32 e = 0; e < 8; ++e)
+		{
+			if (used & (1 << e))
+			{
+				minAlpha = alphas[e] < minAlpha ? alphas[e] : minAlpha;
+				maxAlpha = alphas[e] > maxAlpha ? alphas[e] : maxAlpha;
+			}
+		}
+
+		bc3.alpha0 = (uint8)maxAlpha;
+		bc3.alpha1 = (uint8)minAlpha;
+		if (maxAlpha == minAlpha)
+		{
+			bc3.SetIndices(0);
+			return;
+		}
+
+		//step 0..7 from alpha1 to alpha0 in 16.16 fixed point
+		const uint32 scale = (7 << 16) / (maxAlpha - minAlpha);
+		uint32 entryIndices[8];
+		for (uint32 e = 0; e < 8; ++e)
+		{
+			const int32 offset = (int32)alphas[e] - (int32)minAlpha;
+			entryIndices[e] = bc3StepToIndex[offset <= 0 ? 0 : Min((offset * scale + 0x8000) >> 16, 7)];
+		}
+
+		uint64 indexBits = 0;
+		for (uint32 k = 0; k < 16; ++k)
+			indexBits |= (uint64)entryIndices[entries[k]] << (k * 3);
+		bc3.SetIndices(indexBits);
+	}
+
+	namespace Scalar
+	{
+		template<uint32 format>
+		static void TranscodeETC2ToColorBlocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			BlockPalette palette;
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				GetETC2Palette<false>((const ETC2Block*)source, palette);
+				EncodeColorBlock<format>(palette, *(BC1Block*)dest);
+
+				source += 8;
+				dest += 8;
+			}
+		}
+
+		//BC3 and ATC interpolated alpha share the alpha block, the color block follows it
+		template<uint32 format>
+		static void TranscodeETC2EACToAlphaColorBlocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			BlockPalette palette;
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				EncodeBC3AlphaBlock((const EACBlock*)source, *(BC3AlphaBlock*)dest);
+				GetETC2Palette<false>((const ETC2Block*)(source + 8), palette);
+				EncodeColorBlock<format>(palette, *(BC1Block*)(dest + 8));
+
+				source += 16;
+				dest += 16;
+			}
+		}
+
+		void TranscodeETC2ToBC1Blocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			TranscodeETC2ToColorBlocks<ColorBlockBC1>(source, dest, blockCount);
+		}
+
+		void TranscodeETC2EACToBC3Blocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			TranscodeETC2EACToAlphaColorBlocks<ColorBlockBC1>(source, dest, blockCount);
+		}
+
+		void TranscodeETC2ToATCBlocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			TranscodeETC2ToColorBlocks<ColorBlockATC>(source, dest, blockCount);
+		}
+
+		void TranscodeETC2EACToATCBlocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			TranscodeETC2EACToAlphaColorBlocks<ColorBlockATC>(source, dest, blockCount);
+		}
+	}
+
+	void TranscodeETC2_to_BC1(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, (uint64)((width + 3) / 4) * ((height + 3) / 4) * 8);
+		GetKernels().transcodeETC2ToBC1Blocks(source, dest, ((width + 3) / 4) * ((height + 3) / 4));
+	}
+
+	void TranscodeETC2_EAC_to_BC3(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, (uint64)((width + 3) / 4) * ((height + 3) / 4) * 16);
+		GetKernels().transcodeETC2EACToBC3Blocks(source, dest, ((width + 3) / 4) * ((height + 3) / 4));
+	}
+
+	void TranscodeETC2_to_ATC_RGB(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, (uint64)((width + 3) / 4) * ((height + 3) / 4) * 8);
+		GetKernels().transcodeETC2ToATCBlocks(source, dest, ((width + 3) / 4) * ((height + 3) / 4));
+	}
+
+	void TranscodeETC2_EAC_to_ATC_RGBA(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, (uint64)((width + 3) / 4) * ((height + 3) / 4) * 16);
+		GetKernels().transcodeETC2EACToATCBlocks(source, dest, ((width + 3) / 4) * ((height + 3) / 4));
+	}
+}
\ No newline at end of file
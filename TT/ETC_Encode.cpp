@@ -0,0 +1,575 @@
+#include <string.h>
+#include "ETC.h"
+#include "BCBlock.h"
+#include "ETCBlock.h"
+#include "ETCKernel.h"
+namespace TT
+{
+	static const uint32 unitWeights[16] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+	//The 16 pixels of block (bx, by) in ETC order, k = x * 4 + y. Edge blocks repeat the last column and row.
+	static void LoadBlock(const uint8* source, uint32 sourceRowPitch, uint32 width, uint32 height, uint32 bx, uint32 by, uint32 pixels[16])
+	{
+		for (uint32 x = 0; x < 4; ++x)
+		{
+			const uint32 px = Min(bx * 4 + x, width - 1);
+			for (uint32 y = 0; y < 4; ++y)
+			{
+				const uint32 py = Min(by * 4 + y, height - 1);
+				pixels[x * 4 + y] = *(const uint32*)(source + py * sourceRowPitch + px * 4);
+			}
+		}
+	}
+
+	static inline uint32 GetColorError(uint32 a, uint32 b)
+	{
+		uint32 error = 0;
+		for (uint32 c = 0; c < 24; c += 8)
+		{
+			const int32 d = (int32)((a >> c) & 0xFF) - (int32)((b >> c) & 0xFF);
+			error += d * d;
+		}
+		return error;
+	}
+
+	//Pixels of subblock 0 and 1 when split left/right (flip 0) or top/bottom (flip 1)
+	static void SplitSubblocks(const uint32 pixels[16], uint32 flip, uint32 subblocks[2][8])
+	{
+		uint32 counts[2] = { 0, 0 };
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			const uint32 subblock = flip ? (k & 3) >> 1 : k >> 3;
+			subblocks[subblock][counts[subblock]++] = pixels[k];
+		}
+	}
+
+	//Selectors of the subblock pixels back in block order
+	static void MergeSelectors(const uint8 selectors[2][8], uint32 flip, uint8 blockSelectors[16])
+	{
+		uint32 counts[2] = { 0, 0 };
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			const uint32 subblock = flip ? (k & 3) >> 1 : k >> 3;
+			blockSelectors[k] = selectors[subblock][counts[subblock]++];
+		}
+	}
+
+	//Big-endian, bit 63 is the top bit of the first byte like in the spec tables
+	static inline void StoreBlockBits(uint8* dest, uint64 bits)
+	{
+		for (uint32 i = 0; i < 8; ++i)
+			dest[i] = (uint8)(bits >> (56 - i * 8));
+	}
+
+	static inline uint64 GetSelectorBits(const uint8 selectors[16])
+	{
+		uint32 msb = 0, lsb = 0;
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			msb |= (selectors[k] >> 1) << k;
+			lsb |= (selectors[k] & 1) << k;
+		}
+		return (uint64)msb << 16 | lsb;
+	}
+
+	//T, H and planar blocks are differential blocks whose R, G or B overflows, the bits no field uses are set until
+	//the block decodes in mode. Returns false when no combination of them gets there.
+	static bool StoreOverflowBlock(uint8* dest, uint64 bits, uint64 freeBits, ETC2Block::Mode mode)
+	{
+		uint64 set = 0;
+		do
+		{
+			StoreBlockBits(dest, bits | set);
+			if (((const ETC2Block*)dest)->GetMode() == mode)
+				return true;
+			set = (set - freeBits) & freeBits;
+		} while (set != 0);
+		return false;
+	}
+
+	//Without clamping the distance from a pixel to base +- modifier is its offset from the base (squared, summed over the
+	//channels) minus sum^2 / 3 plus (|sum| - 3 * modifier)^2 / 3, where sum adds up the 3 channel offsets. Only the last term
+	//depends on the table, errors[|sum|] holds it (times 3) for the closer of the two modifiers, two tables per word:
+	//table 2 * i in the low half of errors[|sum|][i]. 8 pixels sum up without carrying into the high half.
+	struct FastTableErrors
+	{
+		uint64 errors[766][4];
+
+		FastTableErrors()
+		{
+			for (int32 sum = 0; sum < 766; ++sum)
+			{
+				for (uint32 i = 0; i < 4; ++i)
+				{
+					uint64 word = 0;
+					for (uint32 half = 0; half < 2; ++half)
+					{
+						const int32* modifiers = intensityModifierDefault[i * 2 + half];
+						const int32 small = sum - 3 * modifiers[0];
+						const int32 large = sum - 3 * modifiers[1];
+						word |= (uint64)Min(small * small, large * large) << (half * 32);
+					}
+					errors[sum][i] = word;
+				}
+			}
+		}
+	};
+
+	//Fast preset: the flip whose subblock means explain the most of the block, the means as base colors and the
+	//table picked from the luminance offsets of the pixels alone. Clamping is ignored while fitting.
+	static void EncodeETC1Fast(const uint32 pixels[16], uint8* dest)
+	{
+		static const FastTableErrors tableErrors;
+
+		//channel sums of the left, right, top and bottom halves, red and blue summed in the 16 bit halves of one word
+		uint32 redBlueSums[4] = { 0, 0, 0, 0 };
+		uint32 greenSums[4] = { 0, 0, 0, 0 };
+		int32 pixelSums[16];
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			const uint32 redBlue = pixels[k] & 0xFF00FF;
+			const uint32 green = (pixels[k] >> 8) & 0xFF;
+			redBlueSums[k >> 3] += redBlue;
+			greenSums[k >> 3] += green;
+			redBlueSums[2 + ((k & 3) >> 1)] += redBlue;
+			greenSums[2 + ((k & 3) >> 1)] += green;
+			pixelSums[k] = (int32)((redBlue & 0xFFFF) + (redBlue >> 16) + green);
+		}
+		int32 sums[4][3];
+		for (uint32 h = 0; h < 4; ++h)
+		{
+			sums[h][0] = redBlueSums[h] & 0xFFFF;
+			sums[h][1] = greenSums[h];
+			sums[h][2] = redBlueSums[h] >> 16;
+		}
+
+		//the squared error of a split into two flat halves is sum(value^2) - sum(half sum^2) / 8, only the second term depends on the flip
+		int32 explained[2] = { 0, 0 };
+		for (uint32 c = 0; c < 3; ++c)
+		{
+			explained[0] += sums[0][c] * sums[0][c] + sums[1][c] * sums[1][c];
+			explained[1] += sums[2][c] * sums[2][c] + sums[3][c] * sums[3][c];
+		}
+		const uint32 flip = explained[1] > explained[0] ? 1 : 0;
+
+		int32 means[2][3];
+		for (uint32 c = 0; c < 3; ++c)
+		{
+			means[0][c] = (sums[flip * 2][c] + 4) >> 3;
+			means[1][c] = (sums[flip * 2 + 1][c] + 4) >> 3;
+		}
+		int32 bases[2][3];
+		uint32 baseColors[2];
+		const bool differential = QuantizeETC1BaseColors(means[0], means[1], bases[0], bases[1], baseColors[0], baseColors[1]);
+		const int32 baseSums[2] =
+		{
+			(int32)((baseColors[0] & 0xFF) + ((baseColors[0] >> 8) & 0xFF) + ((baseColors[0] >> 16) & 0xFF)),
+			(int32)((baseColors[1] & 0xFF) + ((baseColors[1] >> 8) & 0xFF) + ((baseColors[1] >> 16) & 0xFF)),
+		};
+
+		int32 offsetSums[16];
+		uint64 totals[2][4] = {};
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			const uint32 subblock = flip ? (k & 3) >> 1 : k >> 3;
+			const int32 sum = pixelSums[k] - baseSums[subblock];
+			offsetSums[k] = sum;
+			const uint64* errors = tableErrors.errors[sum < 0 ? -sum : sum];
+			for (uint32 i = 0; i < 4; ++i)
+				totals[subblock][i] += errors[i];
+		}
+
+		uint32 tables[2];
+		for (uint32 s = 0; s < 2; ++s)
+		{
+			uint32 bestError = 0xFFFFFFFF;
+			tables[s] = 0;
+			for (uint32 t = 0; t < 8; ++t)
+			{
+				const uint32 error = (uint32)(totals[s][t >> 1] >> ((t & 1) * 32));
+				if (error < bestError)
+				{
+					bestError = error;
+					tables[s] = t;
+				}
+			}
+		}
+
+		uint8 selectors[16];
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			const uint32 subblock = flip ? (k & 3) >> 1 : k >> 3;
+			const int32* modifiers = intensityModifierDefault[tables[subblock]];
+			const int32 offset = offsetSums[k] < 0 ? -offsetSums[k] : offsetSums[k];
+			const int32 small = offset - 3 * modifiers[0];
+			const int32 large = offset - 3 * modifiers[1];
+			selectors[k] = (uint8)((offsetSums[k] < 0 ? 2 : 0) + (large * large < small * small));
+		}
+
+		WriteETC1Block(dest, differential, flip != 0, bases[0], bases[1], tables[0], tables[1], selectors);
+	}
+
+	//One flip of an individual or differential block fitted with FitETC1Subblock
+	struct ETC1Candidate
+	{
+		bool differential;
+		int32 bases[2][3];
+		ETC1SubblockFit fits[2];
+		uint32 error;
+	};
+
+	static void FitETC1Candidate(const uint32 subblocks[2][8], const int32 means[2][3], ETC1Candidate& candidate)
+	{
+		uint32 baseColors[2];
+		candidate.differential = QuantizeETC1BaseColors(means[0], means[1], candidate.bases[0], candidate.bases[1], baseColors[0], baseColors[1]);
+		FitETC1Subblock(baseColors[0], subblocks[0], unitWeights, 8, candidate.fits[0]);
+		FitETC1Subblock(baseColors[1], subblocks[1], unitWeights, 8, candidate.fits[1]);
+		candidate.error = candidate.fits[0].error + candidate.fits[1].error;
+	}
+
+	//Normal and high presets: both flips are fitted exactly, high also moves each base color to the mean of the pixels
+	//minus their modifiers and keeps the refit when it is better. Returns the squared error.
+	static uint32 EncodeETC1(const uint32 pixels[16], bool refine, uint8* dest)
+	{
+		ETC1Candidate best = {};
+		uint32 bestFlip = 0;
+		best.error = 0xFFFFFFFF;
+		for (uint32 flip = 0; flip < 2; ++flip)
+		{
+			uint32 subblocks[2][8];
+			SplitSubblocks(pixels, flip, subblocks);
+			int32 means[2][3];
+			GetMeanColor(subblocks[0], unitWeights, 8, means[0]);
+			GetMeanColor(subblocks[1], unitWeights, 8, means[1]);
+
+			ETC1Candidate candidate;
+			FitETC1Candidate(subblocks, means, candidate);
+			for (uint32 pass = 0; refine && pass < 2; ++pass)
+			{
+				for (uint32 s = 0; s < 2; ++s)
+				{
+					const int32* modifiers = intensityModifierDefault[candidate.fits[s].table];
+					for (uint32 c = 0; c < 3; ++c)
+					{
+						int32 sum = 0;
+						for (uint32 i = 0; i < 8; ++i)
+							sum += (int32)((subblocks[s][i] >> (c * 8)) & 0xFF) - modifiers[candidate.fits[s].selectors[i]];
+						means[s][c] = Clamp((sum + 4) >> 3, 0, 255);
+					}
+				}
+				ETC1Candidate refined;
+				FitETC1Candidate(subblocks, means, refined);
+				if (refined.error >= candidate.error)
+					break;
+				candidate = refined;
+			}
+
+			if (candidate.error < best.error)
+			{
+				best = candidate;
+				bestFlip = flip;
+			}
+		}
+
+		uint8 selectors[2][8];
+		for (uint32 i = 0; i < 8; ++i)
+		{
+			selectors[0][i] = best.fits[0].selectors[i];
+			selectors[1][i] = best.fits[1].selectors[i];
+		}
+		uint8 blockSelectors[16];
+		MergeSelectors(selectors, bestFlip, blockSelectors);
+		WriteETC1Block(dest, best.differential, bestFlip != 0, best.bases[0], best.bases[1], best.fits[0].table, best.fits[1].table, blockSelectors);
+		return best.error;
+	}
+
+	//Least squares plane through each channel, c(x, y) = o + x * (h - o) / 4 + y * (v - o) / 4. Returns the squared error.
+	static uint32 EncodePlanar(const uint32 pixels[16], uint8* dest)
+	{
+		static const uint32 bitCounts[3] = { 6, 7, 6 };
+		int32 o[3], h[3], v[3];
+		for (uint32 c = 0; c < 3; ++c)
+		{
+			//slopes from the sums weighted by x - 1.5 and y - 1.5 (doubled), sum((2x - 3)^2) over the block is 80
+			int32 sum = 0, sumX = 0, sumY = 0;
+			for (uint32 k = 0; k < 16; ++k)
+			{
+				const int32 value = (pixels[k] >> (c * 8)) & 0xFF;
+				sum += value;
+				sumX += (2 * (int32)(k >> 2) - 3) * value;
+				sumY += (2 * (int32)(k & 3) - 3) * value;
+			}
+			//o = mean - 1.5 * slopeX - 1.5 * slopeY, h = o + 4 * slopeX, v = o + 4 * slopeY, slope = 2 * sum / 80
+			const int32 max = (1 << bitCounts[c]) - 1;
+			const int32 origin = 40 * sum - 3 * 8 * sumX - 3 * 8 * sumY; //* 640
+			const int32 values[3] = { origin, origin + 4 * 16 * sumX, origin + 4 * 16 * sumY };
+			int32* targets[3] = { &o[c], &h[c], &v[c] };
+			for (uint32 i = 0; i < 3; ++i)
+			{
+				const int32 scaled = values[i] * max;
+				const int32 quantized = (scaled >= 0 ? scaled + 640 * 255 / 2 : scaled - 640 * 255 / 2) / (640 * 255);
+				*targets[i] = Clamp(quantized, 0, max);
+			}
+		}
+
+		uint64 bits = 0;
+		bits |= (uint64)o[0] << 57;
+		bits |= (uint64)(o[1] >> 6) << 56 | (uint64)(o[1] & 0x3F) << 49;
+		bits |= (uint64)(o[2] >> 5) << 48 | (uint64)((o[2] >> 3) & 0x3) << 43 | (uint64)((o[2] >> 1) & 0x3) << 40 | (uint64)(o[2] & 1) << 39;
+		bits |= (uint64)(h[0] >> 1) << 34 | (uint64)1 << 33 | (uint64)(h[0] & 1) << 32;
+		bits |= (uint64)h[1] << 25;
+		bits |= (uint64)(h[2] >> 5) << 24 | (uint64)(h[2] & 0x1F) << 19;
+		bits |= (uint64)(v[0] >> 3) << 16 | (uint64)(v[0] & 0x7) << 13;
+		bits |= (uint64)(v[1] >> 2) << 8 | (uint64)(v[1] & 0x3) << 6;
+		bits |= (uint64)v[2];
+		if (!StoreOverflowBlock(dest, bits, (uint64)1 << 63 | (uint64)1 << 55 | (uint64)0x7 << 45 | (uint64)1 << 42, ETC2Block::ModePlanar))
+			return 0xFFFFFFFF;
+
+		uint32 decoded[16];
+		((const ETC2Block*)dest)->DecodePlanarMode((uint8*)decoded, 16);
+		uint32 error = 0;
+		for (uint32 k = 0; k < 16; ++k)
+			error += GetColorError(decoded[(k & 3) * 4 + (k >> 2)], pixels[k]);
+		return error;
+	}
+
+	//Nearest of the 4 paint colors for every pixel, returns the squared error
+	static uint32 GetPaintSelectors(const uint32 pixels[16], const uint32 paintColors[4], uint8 selectors[16])
+	{
+		uint32 error = 0;
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			uint32 bestError = 0xFFFFFFFF;
+			for (uint32 p = 0; p < 4; ++p)
+			{
+				const uint32 distance = GetColorError(paintColors[p], pixels[k]);
+				if (distance < bestError)
+				{
+					bestError = distance;
+					selectors[k] = (uint8)p;
+				}
+			}
+			error += bestError;
+		}
+		return error;
+	}
+
+	static inline uint32 AddDistance(int32 r, int32 g, int32 b, int32 distance)
+	{
+		return ClampUint8(r + distance) | ClampUint8(g + distance) << 8 | ClampUint8(b + distance) << 16 | 0xFF000000;
+	}
+
+	//T and H blocks from two clusters of the pixels, split along the channel with the largest range and refined twice.
+	//T paints one cluster with its mean and the other with its mean +- 0 or a distance, H paints both with their mean
+	//+- the distance. Every distance is tried. Returns the squared error.
+	static uint32 EncodeTH(const uint32 pixels[16], uint8* dest)
+	{
+		int32 values[16][3];
+		int32 minValue[3] = { 255, 255, 255 };
+		int32 maxValue[3] = { 0, 0, 0 };
+		for (uint32 k = 0; k < 16; ++k)
+		{
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				values[k][c] = (pixels[k] >> (c * 8)) & 0xFF;
+				minValue[c] = values[k][c] < minValue[c] ? values[k][c] : minValue[c];
+				maxValue[c] = values[k][c] > maxValue[c] ? values[k][c] : maxValue[c];
+			}
+		}
+		const int32 extent[3] = { maxValue[0] - minValue[0], maxValue[1] - minValue[1], maxValue[2] - minValue[2] };
+		const uint32 widest = GetWidestChannel(extent);
+
+		//two rounds of 2-means from the halves of the widest channel
+		uint32 clusters[16];
+		for (uint32 k = 0; k < 16; ++k)
+			clusters[k] = 2 * values[k][widest] > minValue[widest] + maxValue[widest];
+		int32 centers[2][3];
+		for (uint32 round = 0; round < 3; ++round)
+		{
+			int32 sums[2][3] = {};
+			int32 counts[2] = { 0, 0 };
+			for (uint32 k = 0; k < 16; ++k)
+			{
+				for (uint32 c = 0; c < 3; ++c)
+					sums[clusters[k]][c] += values[k][c];
+				++counts[clusters[k]];
+			}
+			for (uint32 i = 0; i < 2; ++i)
+			{
+				for (uint32 c = 0; c < 3; ++c)
+					centers[i][c] = counts[i] ? (sums[i][c] + counts[i] / 2) / counts[i] : (minValue[c] + maxValue[c]) / 2;
+			}
+			if (round == 2)
+				break;
+			for (uint32 k = 0; k < 16; ++k)
+			{
+				int32 distances[2] = { 0, 0 };
+				for (uint32 i = 0; i < 2; ++i)
+				{
+					for (uint32 c = 0; c < 3; ++c)
+						distances[i] += (values[k][c] - centers[i][c]) * (values[k][c] - centers[i][c]);
+				}
+				clusters[k] = distances[1] < distances[0];
+			}
+		}
+
+		int32 colors[2][3];
+		int32 expanded[2][3];
+		for (uint32 i = 0; i < 2; ++i)
+		{
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				colors[i][c] = (centers[i][c] * 15 + 127) / 255;
+				expanded[i][c] = extend_4to8bits(colors[i][c]);
+			}
+		}
+
+		uint32 bestError = 0xFFFFFFFF;
+		uint64 bestBits = 0;
+		uint64 bestFreeBits = 0;
+		ETC2Block::Mode bestMode = ETC2Block::ModeT;
+		uint8 selectors[16];
+
+		//T: either cluster can take the single color
+		for (uint32 single = 0; single < 2; ++single)
+		{
+			const int32* color1 = colors[single];
+			const int32* color2 = colors[single ^ 1];
+			const int32* expanded1 = expanded[single];
+			const int32* expanded2 = expanded[single ^ 1];
+			for (uint32 d = 0; d < 8; ++d)
+			{
+				const int32 distance = distanceTableTH[d];
+				const uint32 paintColors[4] =
+				{
+					AddDistance(expanded1[0], expanded1[1], expanded1[2], 0),
+					AddDistance(expanded2[0], expanded2[1], expanded2[2], distance),
+					AddDistance(expanded2[0], expanded2[1], expanded2[2], 0),
+					AddDistance(expanded2[0], expanded2[1], expanded2[2], -distance),
+				};
+				const uint32 error = GetPaintSelectors(pixels, paintColors, selectors);
+				if (error < bestError)
+				{
+					bestError = error;
+					bestMode = ETC2Block::ModeT;
+					bestBits = (uint64)(color1[0] >> 2) << 59 | (uint64)(color1[0] & 0x3) << 56 | (uint64)color1[1] << 52 | (uint64)color1[2] << 48 |
+						(uint64)color2[0] << 44 | (uint64)color2[1] << 40 | (uint64)color2[2] << 36 |
+						(uint64)(d >> 1) << 34 | (uint64)1 << 33 | (uint64)(d & 1) << 32 | GetSelectorBits(selectors);
+					bestFreeBits = (uint64)0x7 << 61 | (uint64)1 << 58;
+				}
+			}
+		}
+
+		//H: the low distance bit is whether the first color is the larger 12 bit value, the colors are swapped to match it
+		const int32 packed[2] = { colors[0][0] << 8 | colors[0][1] << 4 | colors[0][2], colors[1][0] << 8 | colors[1][1] << 4 | colors[1][2] };
+		for (uint32 d = 0; d < 8; ++d)
+		{
+			const uint32 first = (d & 1) == (uint32)(packed[0] >= packed[1]) ? 0 : 1;
+			if ((packed[first] >= packed[first ^ 1]) != ((d & 1) != 0))
+				continue;
+			const int32* color1 = colors[first];
+			const int32* color2 = colors[first ^ 1];
+			const int32* expanded1 = expanded[first];
+			const int32* expanded2 = expanded[first ^ 1];
+			const int32 distance = distanceTableTH[d];
+			const uint32 paintColors[4] =
+			{
+				AddDistance(expanded1[0], expanded1[1], expanded1[2], distance),
+				AddDistance(expanded1[0], expanded1[1], expanded1[2], -distance),
+				AddDistance(expanded2[0], expanded2[1], expanded2[2], distance),
+				AddDistance(expanded2[0], expanded2[1], expanded2[2], -distance),
+			};
+			const uint32 error = GetPaintSelectors(pixels, paintColors, selectors);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestMode = ETC2Block::ModeH;
+				bestBits = (uint64)color1[0] << 59 | (uint64)(color1[1] >> 1) << 56 | (uint64)(color1[1] & 1) << 52 |
+					(uint64)(color1[2] >> 3) << 51 | (uint64)((color1[2] >> 1) & 0x3) << 48 | (uint64)(color1[2] & 1) << 47 |
+					(uint64)color2[0] << 43 | (uint64)(color2[1] >> 1) << 40 | (uint64)(color2[1] & 1) << 39 | (uint64)color2[2] << 35 |
+					(uint64)(d >> 2) << 34 | (uint64)1 << 33 | (uint64)((d >> 1) & 1) << 32 | GetSelectorBits(selectors);
+				bestFreeBits = (uint64)1 << 63 | (uint64)0x7 << 53 | (uint64)1 << 50;
+			}
+		}
+
+		if (!StoreOverflowBlock(dest, bestBits, bestFreeBits, bestMode))
+			return 0xFFFFFFFF;
+		return bestError;
+	}
+
+	namespace Scalar
+	{
+		void EncodeETC1FastRow(const uint8* source, uint32 sourceRowPitch, uint8* dest, uint32 blockCount)
+		{
+			uint32 pixels[16];
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				LoadBlock(source, sourceRowPitch, 4, 4, 0, 0, pixels);
+				EncodeETC1Fast(pixels, dest);
+
+				source += 16;
+				dest += 8;
+			}
+		}
+	}
+
+	static void EncodeBlock(const uint32 pixels[16], TTETCQuality quality, bool etc2, uint8* dest)
+	{
+		if (quality == TT_ETC_QUALITY_FAST)
+		{
+			EncodeETC1Fast(pixels, dest);
+			return;
+		}
+
+		const uint32 error = EncodeETC1(pixels, quality == TT_ETC_QUALITY_HIGH, dest);
+		if (!etc2 || error == 0)
+			return;
+
+		uint8 candidate[8];
+		uint32 bestError = error;
+		const uint32 planarError = EncodePlanar(pixels, candidate);
+		if (planarError < bestError)
+		{
+			bestError = planarError;
+			memcpy(dest, candidate, 8);
+		}
+		if (quality == TT_ETC_QUALITY_HIGH && EncodeTH(pixels, candidate) < bestError)
+			memcpy(dest, candidate, 8);
+	}
+
+	static void EncodeImage(const uint8* source, uint8* dest, uint32 width, uint32 height, uint32 sourceRowPitch, TTETCQuality quality, bool etc2)
+	{
+		if (sourceRowPitch == 0)
+			sourceRowPitch = width * 4;
+
+		//the fast preset encodes the whole blocks of a block row with the kernel, the edge blocks are loaded one by one
+		const EncodeRowFunc encodeFastRow = GetKernels().encodeETC1FastRow;
+		uint32 pixels[16];
+		for (uint32 by = 0; by < (height + 3) / 4; ++by)
+		{
+			uint32 bx = 0;
+			if (quality == TT_ETC_QUALITY_FAST && by * 4 + 4 <= height)
+			{
+				bx = width / 4;
+				encodeFastRow(source + (size_t)by * 4 * sourceRowPitch, sourceRowPitch, dest, bx);
+				dest += bx * 8;
+			}
+			for (; bx < (width + 3) / 4; ++bx)
+			{
+				LoadBlock(source, sourceRowPitch, width, height, bx, by, pixels);
+				EncodeBlock(pixels, quality, etc2, dest);
+				dest += 8;
+			}
+		}
+	}
+
+	void TranscodeRGBA8_to_ETC1(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 sourceRowPitch, const TTETCQuality quality)
+	{
+		EncodeImage(source, dest, width, height, sourceRowPitch, quality, false);
+	}
+
+	void TranscodeRGBA8_to_ETC2(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 sourceRowPitch, const TTETCQuality quality)
+	{
+		EncodeImage(source, dest, width, height, sourceRowPitch, quality, true);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "ETCKernel.h"
+#if TT_SIMD128
+#include <wasm_simd128.h>
+#include "ETCBlock.h"
+namespace TT
+{
+	//wasm-simd128 port of ETC_SSE41.cpp, wasm_i8x16_swizzle zeroes lanes with an index >= 16 just like pshufb does with the high bit set
+	namespace SIMD128
+	{
+		//2 bit pixel indices of an ETC2 block, one byte per pixel in row-major order
+		static inline v128_t UnpackETC2Indices(v128_t block)
+		{
+			//pixel (x, y) is bit x*4+y of byte5/byte7 (x < 2) or byte4/byte6 (x >= 2)
+			const v128_t msbCtrl = wasm_i8x16_const(5, 5, 4, 4, 5, 5, 4, 4, 5, 5, 4, 4, 5, 5, 4, 4);
+			const v128_t lsbCtrl = wasm_i8x16_const(7, 7, 6, 6, 7, 7, 6, 6, 7, 7, 6, 6, 7, 7, 6, 6);
+			const v128_t bitMask = wasm_i8x16_const(1, 16, 1, 16, 2, 32, 2, 32, 4, 64, 4, 64, 8, -128, 8, -128);
+
+			v128_t msb = wasm_v128_and(wasm_i8x16_swizzle(block, msbCtrl), bitMask);
+			v128_t lsb = wasm_v128_and(wasm_i8x16_swizzle(block, lsbCtrl), bitMask);
+			msb = wasm_v128_and(wasm_i8x16_eq(msb, bitMask), wasm_i8x16_splat(2));
+			lsb = wasm_v128_and(wasm_i8x16_eq(lsb, bitMask), wasm_i8x16_splat(1));
+			return wasm_v128_or(msb, lsb);
+		}
+
+		//byte swizzles that expand the 4 pixel indices of row j into 4 RGBA8 palette lookups
+		static inline void MakeRowControls(v128_t indices, v128_t ctrl[4])
+		{
+			const v128_t byteOffset = wasm_i32x4_splat(0x03020100);
+			const v128_t indices4 = wasm_i8x16_shl(indices, 2);
+			ctrl[0] = wasm_i8x16_add(wasm_i8x16_swizzle(indices4, wasm_i8x16_const(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3)), byteOffset);
+			ctrl[1] = wasm_i8x16_add(wasm_i8x16_swizzle(indices4, wasm_i8x16_const(4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7)), byteOffset);
+			ctrl[2] = wasm_i8x16_add(wasm_i8x16_swizzle(indices4, wasm_i8x16_const(8, 8, 8, 8, 9, 9, 9, 9, 10, 10, 10, 10, 11, 11, 11, 11)), byteOffset);
+			ctrl[3] = wasm_i8x16_add(wasm_i8x16_swizzle(indices4, wasm_i8x16_const(12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15)), byteOffset);
+		}
+
+		//the 4 colors of a subblock, base color plus intensityModifierDefault[tableIdx]
+		static inline v128_t MakeSubblockPalette(uint32 color, uint32 tableIdx)
+		{
+			const v128_t palette = wasm_u8x16_add_sat(wasm_i32x4_splat(color), wasm_v128_load(modifierAdd[tableIdx]));
+			return wasm_u8x16_sub_sat(palette, wasm_v128_load(modifierSub[tableIdx]));
+		}
+
+		//intensityModifierNonOpaque keeps the base color in entry 0 and makes entry 2 transparent black
+		static inline v128_t MakeNonOpaqueSubblockPalette(uint32 color, uint32 tableIdx)
+		{
+			const v128_t palette = wasm_v128_bitselect(wasm_i32x4_splat(color), MakeSubblockPalette(color, tableIdx), wasm_i32x4_const(-1, 0, 0, 0));
+			return wasm_v128_and(palette, wasm_i32x4_const(-1, -1, 0, -1));
+		}
+
+		static inline void DecodeSubblocks(const ETC2Block* block, v128_t palette0, v128_t palette1, v128_t blockBits, v128_t rows[4])
+		{
+			v128_t ctrl[4];
+			MakeRowControls(UnpackETC2Indices(blockBits), ctrl);
+
+			if (block->GetFlip())
+			{
+				//Two 4x2-pixel subblocks on top of each other
+				rows[0] = wasm_i8x16_swizzle(palette0, ctrl[0]);
+				rows[1] = wasm_i8x16_swizzle(palette0, ctrl[1]);
+				rows[2] = wasm_i8x16_swizzle(palette1, ctrl[2]);
+				rows[3] = wasm_i8x16_swizzle(palette1, ctrl[3]);
+			}
+			else
+			{
+				//Two 2x4-pixel subblocks side-by-side
+				const v128_t leftHalf = wasm_i32x4_const(-1, -1, 0, 0);
+				for (uint32 j = 0; j < 4; j++)
+					rows[j] = wasm_v128_bitselect(wasm_i8x16_swizzle(palette0, ctrl[j]), wasm_i8x16_swizzle(palette1, ctrl[j]), leftHalf);
+			}
+		}
+
+		static inline void DecodeIndividualOrDifferentialMode(const ETC2Block* block, v128_t blockBits, v128_t rows[4])
+		{
+			uint32 color1, color2;
+			block->GetSubblockBaseColors(color1, color2);
+			DecodeSubblocks(block, MakeSubblockPalette(color1, block->GetTableIndex1()), MakeSubblockPalette(color2, block->GetTableIndex2()), blockBits, rows);
+		}
+
+		static inline void DecodePaintColors(const uint32 paintColors[4], v128_t blockBits, v128_t rows[4])
+		{
+			const v128_t palette = wasm_v128_load(paintColors);
+
+			v128_t ctrl[4];
+			MakeRowControls(UnpackETC2Indices(blockBits), ctrl);
+			for (uint32 j = 0; j < 4; j++)
+				rows[j] = wasm_i8x16_swizzle(palette, ctrl[j]);
+		}
+
+		static inline void DecodePlanarMode(const ETC2Block* block, v128_t rows[4])
+		{
+			int32 o[3], h[3], v[3];
+			block->GetPlanarColors(o, h, v);
+
+			const v128_t ho = wasm_i16x8_make(h[0] - o[0], h[1] - o[1], h[2] - o[2], 0, h[0] - o[0], h[1] - o[1], h[2] - o[2], 0);
+			const v128_t vo = wasm_i16x8_make(v[0] - o[0], v[1] - o[1], v[2] - o[2], 0, v[0] - o[0], v[1] - o[1], v[2] - o[2], 0);
+			const v128_t origin = wasm_i16x8_make(o[0], o[1], o[2], 255, o[0], o[1], o[2], 255);
+
+			//x = 0, 1 in the low register and x = 2, 3 in the high one
+			const v128_t xLo = wasm_i16x8_mul(wasm_i16x8_const(0, 0, 0, 0, 1, 1, 1, 1), ho);
+			const v128_t xHi = wasm_i16x8_mul(wasm_i16x8_const(2, 2, 2, 2, 3, 3, 3, 3), ho);
+
+			v128_t y = wasm_i16x8_splat(2);
+			for (uint32 j = 0; j < 4; j++)
+			{
+				v128_t lo = wasm_i16x8_add(wasm_i16x8_shr(wasm_i16x8_add(xLo, y), 2), origin);
+				v128_t hi = wasm_i16x8_add(wasm_i16x8_shr(wasm_i16x8_add(xHi, y), 2), origin);
+				rows[j] = wasm_u8x16_narrow_i16x8(lo, hi);
+				y = wasm_i16x8_add(y, vo);
+			}
+		}
+
+		template<uint32 mode>
+		static inline void DecodeETC2BlockInMode(const uint8* source, v128_t rows[4])
+		{
+			const ETC2Block* block = (const ETC2Block*)source;
+			const v128_t blockBits = wasm_v128_load64_zero(source);
+
+			uint32 paintColors[4];
+			switch (mode)
+			{
+			case ETC2Block::ModeT:
+				block->GetTModePaintColors(paintColors);
+				DecodePaintColors(paintColors, blockBits, rows);
+				break;
+			case ETC2Block::ModeH:
+				block->GetHModePaintColors(paintColors);
+				DecodePaintColors(paintColors, blockBits, rows);
+				break;
+			case ETC2Block::ModePlanar:
+				DecodePlanarMode(block, rows);
+				break;
+			default:
+				DecodeIndividualOrDifferentialMode(block, blockBits, rows);
+				break;
+			}
+		}
+
+		static inline void DecodeETC2Block(const uint8* source, v128_t rows[4])
+		{
+			switch (((const ETC2Block*)source)->GetMode())
+			{
+			case ETC2Block::ModeT:
+				DecodeETC2BlockInMode<ETC2Block::ModeT>(source, rows);
+				break;
+			case ETC2Block::ModeH:
+				DecodeETC2BlockInMode<ETC2Block::ModeH>(source, rows);
+				break;
+			case ETC2Block::ModePlanar:
+				DecodeETC2BlockInMode<ETC2Block::ModePlanar>(source, rows);
+				break;
+			default:
+				DecodeETC2BlockInMode<ETC2Block::ModeDifferential>(source, rows);
+				break;
+			}
+		}
+
+		//See ETC2Block::DecodePunchThrough, opaque and planar blocks take the RGB8 paths
+		static inline void DecodePunchThroughBlock(const uint8* source, v128_t rows[4])
+		{
+			const ETC2Block* block = (const ETC2Block*)source;
+			const ETC2Block::Mode mode = block->GetPunchThroughMode();
+			if (mode == ETC2Block::ModePlanar || block->IsOpaque())
+			{
+				if (mode == ETC2Block::ModeT)
+					DecodeETC2BlockInMode<ETC2Block::ModeT>(source, rows);
+				else if (mode == ETC2Block::ModeH)
+					DecodeETC2BlockInMode<ETC2Block::ModeH>(source, rows);
+				else if (mode == ETC2Block::ModePlanar)
+					DecodeETC2BlockInMode<ETC2Block::ModePlanar>(source, rows);
+				else
+					DecodeETC2BlockInMode<ETC2Block::ModeDifferential>(source, rows);
+				return;
+			}
+
+			const v128_t blockBits = wasm_v128_load64_zero(source);
+			if (mode == ETC2Block::ModeDifferential)
+			{
+				uint32 color1, color2;
+				block->GetDifferentialBaseColors(color1, color2);
+				DecodeSubblocks(block, MakeNonOpaqueSubblockPalette(color1, block->GetTableIndex1()), MakeNonOpaqueSubblockPalette(color2, block->GetTableIndex2()), blockBits, rows);
+				return;
+			}
+
+			uint32 paintColors[4];
+			if (mode == ETC2Block::ModeT)
+				block->GetTModePaintColors(paintColors);
+			else
+				block->GetHModePaintColors(paintColors);
+			paintColors[2] = 0;
+			DecodePaintColors(paintColors, blockBits, rows);
+		}
+
+		//3 bit pixel indices of an EAC block, one byte per pixel in row-major order
+		static inline v128_t UnpackEACIndices(const uint8* source)
+		{
+			const v128_t blockBits = wasm_v128_load64_zero(source);
+
+			//see ETC_SSE41.cpp, each index is shifted to the top of its 16-bit window by a multiply
+			const v128_t windowLo = wasm_i8x16_const(3, 2, 4, 3, 6, 5, 7, 6, 3, 2, 4, 3, 6, 5, 7, 6);
+			const v128_t windowHi = wasm_i8x16_const(3, 2, 5, 4, 6, 5, -1, 7, 4, 3, 5, 4, 7, 6, -1, 7);
+			const v128_t shiftLo = wasm_i16x8_const(1, 16, 1, 16, 8, 128, 8, 128);
+			const v128_t shiftHi = wasm_i16x8_const(64, 4, 64, 4, 2, 32, 2, 32);
+
+			v128_t lo = wasm_u16x8_shr(wasm_i16x8_mul(wasm_i8x16_swizzle(blockBits, windowLo), shiftLo), 13);
+			v128_t hi = wasm_u16x8_shr(wasm_i16x8_mul(wasm_i8x16_swizzle(blockBits, windowHi), shiftHi), 13);
+			return wasm_u8x16_narrow_i16x8(lo, hi);
+		}
+
+		//8 bit alpha of an EAC block, one byte per pixel in row-major order
+		static inline v128_t DecodeEACBlock(const uint8* source)
+		{
+			const int32 baseCodeword = source[0];
+			const int32 multiplier = source[1] >> 4;
+			const uint32 tableIdx = source[1] & 0xF;
+
+			v128_t palette = wasm_i16x8_mul(wasm_i16x8_splat((int16)multiplier), wasm_v128_load(modifierAlpha[tableIdx]));
+			palette = wasm_i16x8_add(palette, wasm_i16x8_splat((int16)baseCodeword));
+			palette = wasm_u8x16_narrow_i16x8(palette, palette);
+
+			return wasm_i8x16_swizzle(palette, UnpackEACIndices(source));
+		}
+
+		//see ETC_SSE41.cpp, the 8 values of an R11/RG11 channel block bit-replicated to 16 bits
+		template<bool isSigned>
+		static inline v128_t GetEACChannelPalette(const uint8* source)
+		{
+			int32 base;
+			if (isSigned)
+			{
+				//-128 is not a valid signed base codeword and is treated as -127
+				base = (int8)source[0];
+				base = (base == -128 ? -127 : base) * 8;
+			}
+			else
+			{
+				base = source[0] * 8 + 4;
+			}
+			const int32 multiplier = source[1] >> 4;
+			const int32 scale = multiplier == 0 ? 1 : multiplier * 8;
+			const uint32 tableIdx = source[1] & 0xF;
+
+			v128_t palette = wasm_i16x8_mul(wasm_i16x8_splat((int16)scale), wasm_v128_load(modifierAlpha[tableIdx]));
+			palette = wasm_i16x8_add(palette, wasm_i16x8_splat((int16)base));
+			if (isSigned)
+			{
+				palette = wasm_i16x8_min(wasm_i16x8_max(palette, wasm_i16x8_splat(-1023)), wasm_i16x8_splat(1023));
+				const v128_t magnitude = wasm_i16x8_abs(palette);
+				const v128_t replicated = wasm_v128_or(wasm_i16x8_shl(magnitude, 5), wasm_u16x8_shr(magnitude, 5));
+				return wasm_v128_bitselect(wasm_i16x8_neg(replicated), replicated, wasm_i16x8_lt(palette, wasm_i16x8_splat(0)));
+			}
+			palette = wasm_i16x8_min(wasm_i16x8_max(palette, wasm_i16x8_splat(0)), wasm_i16x8_splat(2047));
+			return wasm_v128_or(wasm_i16x8_shl(palette, 5), wasm_u16x8_shr(palette, 6));
+		}
+
+		//One R11 channel: 16 bit values of rows 0-1 and rows 2-3, or the 8 bit values of all rows in values[0]
+		template<bool isSigned, bool is16Bits>
+		static inline void DecodeEACChannel(const uint8* source, v128_t values[2])
+		{
+			const v128_t palette = GetEACChannelPalette<isSigned>(source);
+			const v128_t indices = UnpackEACIndices(source);
+			if (is16Bits)
+			{
+				const v128_t indices2 = wasm_i8x16_add(indices, indices);
+				const v128_t byteOffset = wasm_i16x8_splat(0x0100);
+				values[0] = wasm_i8x16_swizzle(palette, wasm_i8x16_add(wasm_i8x16_swizzle(indices2, wasm_i8x16_const(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7)), byteOffset));
+				values[1] = wasm_i8x16_swizzle(palette, wasm_i8x16_add(wasm_i8x16_swizzle(indices2, wasm_i8x16_const(8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15)), byteOffset));
+			}
+			else if (isSigned)
+			{
+				//high byte rounded towards zero
+				const v128_t high = wasm_i16x8_shr(wasm_i16x8_add(palette, wasm_v128_and(wasm_i16x8_shr(palette, 15), wasm_i16x8_splat(255))), 8);
+				values[0] = wasm_i8x16_swizzle(wasm_i8x16_narrow_i16x8(high, high), indices);
+			}
+			else
+			{
+				const v128_t high = wasm_u16x8_shr(palette, 8);
+				values[0] = wasm_i8x16_swizzle(wasm_u8x16_narrow_i16x8(high, high), indices);
+			}
+		}
+
+		//move the alpha of pixel row j into byte 3 of each RGBA8 pixel
+		static inline void MergeAlpha(v128_t rows[4], v128_t alpha)
+		{
+			const v128_t colorMask = wasm_i32x4_splat(0x00FFFFFF);
+			rows[0] = wasm_v128_bitselect(rows[0], wasm_i8x16_swizzle(alpha, wasm_i8x16_const(-1, -1, -1, 0, -1, -1, -1, 1, -1, -1, -1, 2, -1, -1, -1, 3)), colorMask);
+			rows[1] = wasm_v128_bitselect(rows[1], wasm_i8x16_swizzle(alpha, wasm_i8x16_const(-1, -1, -1, 4, -1, -1, -1, 5, -1, -1, -1, 6, -1, -1, -1, 7)), colorMask);
+			rows[2] = wasm_v128_bitselect(rows[2], wasm_i8x16_swizzle(alpha, wasm_i8x16_const(-1, -1, -1, 8, -1, -1, -1, 9, -1, -1, -1, 10, -1, -1, -1, 11)), colorMask);
+			rows[3] = wasm_v128_bitselect(rows[3], wasm_i8x16_swizzle(alpha, wasm_i8x16_const(-1, -1, -1, 12, -1, -1, -1, 13, -1, -1, -1, 14, -1, -1, -1, 15)), colorMask);
+		}
+
+		static inline void StoreRows(uint8* dest, uint32 destRowPitch, const v128_t rows[4])
+		{
+			wasm_v128_store(dest, rows[0]);
+			wasm_v128_store(dest + destRowPitch, rows[1]);
+			wasm_v128_store(dest + destRowPitch * 2, rows[2]);
+			wasm_v128_store(dest + destRowPitch * 3, rows[3]);
+		}
+
+		void DecodeETC2Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				v128_t rows[4];
+				DecodeETC2Block(source, rows);
+				StoreRows(dest, destRowPitch, rows);
+
+				source += 8;
+				dest += 16;
+			}
+		}
+
+		void DecodeETC2A1Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				v128_t rows[4];
+				DecodePunchThroughBlock(source, rows);
+				StoreRows(dest, destRowPitch, rows);
+
+				source += 8;
+				dest += 16;
+			}
+		}
+
+		void DecodeETC2EACRow(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				v128_t rows[4];
+				DecodeETC2Block(source + 8, rows);
+
+				MergeAlpha(rows, DecodeEACBlock(source));
+				StoreRows(dest, destRowPitch, rows);
+
+				source += 16;
+				dest += 16;
+			}
+		}
+
+		template<bool isSigned, uint32 channels, bool is16Bits>
+		static void DecodeEACChannelRow(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			const uint32 pixelSize = channels * (is16Bits ? 2 : 1);
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				v128_t red[2], green[2];
+				DecodeEACChannel<isSigned, is16Bits>(source, red);
+				if (channels == 2)
+					DecodeEACChannel<isSigned, is16Bits>(source + 8, green);
+
+				if (channels == 2 && is16Bits)
+				{
+					wasm_v128_store(dest, wasm_i16x8_shuffle(red[0], green[0], 0, 8, 1, 9, 2, 10, 3, 11));
+					wasm_v128_store(dest + destRowPitch, wasm_i16x8_shuffle(red[0], green[0], 4, 12, 5, 13, 6, 14, 7, 15));
+					wasm_v128_store(dest + destRowPitch * 2, wasm_i16x8_shuffle(red[1], green[1], 0, 8, 1, 9, 2, 10, 3, 11));
+					wasm_v128_store(dest + destRowPitch * 3, wasm_i16x8_shuffle(red[1], green[1], 4, 12, 5, 13, 6, 14, 7, 15));
+				}
+				else if (channels == 2 || is16Bits)
+				{
+					//8 bytes per row
+					const v128_t rows01 = channels == 2 ? wasm_i8x16_shuffle(red[0], green[0], 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23) : red[0];
+					const v128_t rows23 = channels == 2 ? wasm_i8x16_shuffle(red[0], green[0], 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31) : red[1];
+					wasm_v128_store64_lane(dest, rows01, 0);
+					wasm_v128_store64_lane(dest + destRowPitch, rows01, 1);
+					wasm_v128_store64_lane(dest + destRowPitch * 2, rows23, 0);
+					wasm_v128_store64_lane(dest + destRowPitch * 3, rows23, 1);
+				}
+				else
+				{
+					wasm_v128_store32_lane(dest, red[0], 0);
+					wasm_v128_store32_lane(dest + destRowPitch, red[0], 1);
+					wasm_v128_store32_lane(dest + destRowPitch * 2, red[0], 2);
+					wasm_v128_store32_lane(dest + destRowPitch * 3, red[0], 3);
+				}
+
+				source += channels * 8;
+				dest += pixelSize * 4;
+			}
+		}
+
+		const DecodeRowFunc decodeEACChannelRows[8] =
+		{
+			DecodeEACChannelRow<false, 1, false>, DecodeEACChannelRow<false, 1, true>, DecodeEACChannelRow<false, 2, false>, DecodeEACChannelRow<false, 2, true>,
+			DecodeEACChannelRow<true, 1, false>, DecodeEACChannelRow<true, 1, true>, DecodeEACChannelRow<true, 2, false>, DecodeEACChannelRow<true, 2, true>,
+		};
+
+		template<uint32 mode, bool withAlpha>
+		static void DecodeModeRun(const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count)
+		{
+			for (uint32 i = 0; i < count; ++i)
+			{
+				const uint8* block = source + blockIndices[i] * blockSize;
+
+				v128_t rows[4];
+				DecodeETC2BlockInMode<mode>(withAlpha ? block + 8 : block, rows);
+				if (withAlpha)
+					MergeAlpha(rows, DecodeEACBlock(block));
+				StoreRows(dest + blockIndices[i] * 16, destRowPitch, rows);
+			}
+		}
+
+		void DecodeETC2ModeRun(uint32 mode, const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count)
+		{
+			typedef void (*RunFunc)(const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count);
+			static const RunFunc runs[2][5] =
+			{
+				{
+					DecodeModeRun<ETC2Block::ModeIndividual, false>, DecodeModeRun<ETC2Block::ModeDifferential, false>,
+					DecodeModeRun<ETC2Block::ModeT, false>, DecodeModeRun<ETC2Block::ModeH, false>, DecodeModeRun<ETC2Block::ModePlanar, false>,
+				},
+				{
+					DecodeModeRun<ETC2Block::ModeIndividual, true>, DecodeModeRun<ETC2Block::ModeDifferential, true>,
+					DecodeModeRun<ETC2Block::ModeT, true>, DecodeModeRun<ETC2Block::ModeH, true>, DecodeModeRun<ETC2Block::ModePlanar, true>,
+				},
+			};
+			runs[blockSize == 16][mode](source, blockSize, dest, destRowPitch, blockIndices, count);
+		}
+	}
+}
+#endif
\ No newline at end of file
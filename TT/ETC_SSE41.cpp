@@ -0,0 +1,1089 @@
+#include "ETCKernel.h"
+#if TT_SSE41
+#include <smmintrin.h>
+#include <string.h>
+#include "ETCBlock.h"
+#include "BCBlock.h"
+
+//Only the code below is compiled for SSE4.1, no -msse4.1 needed. The inline functions of the headers above stay
+//baseline, otherwise the linker could keep an SSE4.1 copy of them for the scalar path too.
+#if defined __clang__
+#pragma clang attribute push(__attribute__((target("sse4.1"))), apply_to = function)
+#elif defined __GNUC__
+#pragma GCC target("sse4.1")
+#endif
+namespace TT
+{
+	namespace SSE41
+	{
+		//2 bit pixel indices of an ETC2 block, one byte per pixel in row-major order
+		static inline __m128i UnpackETC2Indices(__m128i block)
+		{
+			//pixel (x, y) is bit x*4+y of byte5/byte7 (x < 2) or byte4/byte6 (x >= 2)
+			const __m128i msbCtrl = _mm_setr_epi8(5, 5, 4, 4, 5, 5, 4, 4, 5, 5, 4, 4, 5, 5, 4, 4);
+			const __m128i lsbCtrl = _mm_setr_epi8(7, 7, 6, 6, 7, 7, 6, 6, 7, 7, 6, 6, 7, 7, 6, 6);
+			const __m128i bitMask = _mm_setr_epi8(1, 16, 1, 16, 2, 32, 2, 32, 4, 64, 4, 64, 8, (char)128, 8, (char)128);
+
+			__m128i msb = _mm_and_si128(_mm_shuffle_epi8(block, msbCtrl), bitMask);
+			__m128i lsb = _mm_and_si128(_mm_shuffle_epi8(block, lsbCtrl), bitMask);
+			msb = _mm_and_si128(_mm_cmpeq_epi8(msb, bitMask), _mm_set1_epi8(2));
+			lsb = _mm_and_si128(_mm_cmpeq_epi8(lsb, bitMask), _mm_set1_epi8(1));
+			return _mm_or_si128(msb, lsb);
+		}
+
+		//byte shuffle controls that expand the 4 pixel indices of row j into 4 RGBA8 palette lookups
+		static inline void MakeRowControls(__m128i indices, __m128i ctrl[4])
+		{
+			const __m128i byteOffset = _mm_set1_epi32(0x03020100);
+			const __m128i indices4 = _mm_slli_epi16(indices, 2);
+			ctrl[0] = _mm_add_epi8(_mm_shuffle_epi8(indices4, _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3)), byteOffset);
+			ctrl[1] = _mm_add_epi8(_mm_shuffle_epi8(indices4, _mm_setr_epi8(4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7)), byteOffset);
+			ctrl[2] = _mm_add_epi8(_mm_shuffle_epi8(indices4, _mm_setr_epi8(8, 8, 8, 8, 9, 9, 9, 9, 10, 10, 10, 10, 11, 11, 11, 11)), byteOffset);
+			ctrl[3] = _mm_add_epi8(_mm_shuffle_epi8(indices4, _mm_setr_epi8(12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15)), byteOffset);
+		}
+
+		//the 4 colors of a subblock, base color plus intensityModifierDefault[tableIdx]
+		static inline __m128i MakeSubblockPalette(uint32 color, uint32 tableIdx)
+		{
+			const __m128i palette = _mm_adds_epu8(_mm_set1_epi32(color), _mm_load_si128((const __m128i*)modifierAdd[tableIdx]));
+			return _mm_subs_epu8(palette, _mm_load_si128((const __m128i*)modifierSub[tableIdx]));
+		}
+
+		//intensityModifierNonOpaque keeps the base color in entry 0 and makes entry 2 transparent black
+		static inline __m128i MakeNonOpaqueSubblockPalette(uint32 color, uint32 tableIdx)
+		{
+			const __m128i palette = _mm_blend_epi16(MakeSubblockPalette(color, tableIdx), _mm_set1_epi32(color), 0x03);
+			return _mm_and_si128(palette, _mm_setr_epi32(-1, -1, 0, -1));
+		}
+
+		static inline void DecodeSubblocks(const ETC2Block* block, __m128i palette0, __m128i palette1, __m128i indices, __m128i rows[4])
+		{
+			__m128i ctrl[4];
+			MakeRowControls(indices, ctrl);
+
+			if (block->GetFlip())
+			{
+				//Two 4x2-pixel subblocks on top of each other
+				rows[0] = _mm_shuffle_epi8(palette0, ctrl[0]);
+				rows[1] = _mm_shuffle_epi8(palette0, ctrl[1]);
+				rows[2] = _mm_shuffle_epi8(palette1, ctrl[2]);
+				rows[3] = _mm_shuffle_epi8(palette1, ctrl[3]);
+			}
+			else
+			{
+				//Two 2x4-pixel subblocks side-by-side
+				const __m128i rightHalf = _mm_setr_epi32(0, 0, -1, -1);
+				for (uint32 j = 0; j < 4; j++)
+					rows[j] = _mm_blendv_epi8(_mm_shuffle_epi8(palette0, ctrl[j]), _mm_shuffle_epi8(palette1, ctrl[j]), rightHalf);
+			}
+		}
+
+		static inline void DecodeIndividualOrDifferentialMode(const ETC2Block* block, __m128i indices, __m128i rows[4])
+		{
+			uint32 color1, color2;
+			block->GetSubblockBaseColors(color1, color2);
+			DecodeSubblocks(block, MakeSubblockPalette(color1, block->GetTableIndex1()), MakeSubblockPalette(color2, block->GetTableIndex2()), indices, rows);
+		}
+
+		static inline void DecodePaintColors(const uint32 paintColors[4], __m128i indices, __m128i rows[4])
+		{
+			const __m128i palette = _mm_loadu_si128((const __m128i*)paintColors);
+
+			__m128i ctrl[4];
+			MakeRowControls(indices, ctrl);
+			for (uint32 j = 0; j < 4; j++)
+				rows[j] = _mm_shuffle_epi8(palette, ctrl[j]);
+		}
+
+		static inline void DecodePlanarMode(const ETC2Block* block, __m128i rows[4])
+		{
+			int32 o[3], h[3], v[3];
+			block->GetPlanarColors(o, h, v);
+
+			const __m128i ho = _mm_setr_epi16(h[0] - o[0], h[1] - o[1], h[2] - o[2], 0, h[0] - o[0], h[1] - o[1], h[2] - o[2], 0);
+			const __m128i vo = _mm_setr_epi16(v[0] - o[0], v[1] - o[1], v[2] - o[2], 0, v[0] - o[0], v[1] - o[1], v[2] - o[2], 0);
+			const __m128i origin = _mm_setr_epi16(o[0], o[1], o[2], 255, o[0], o[1], o[2], 255);
+
+			//x = 0, 1 in the low register and x = 2, 3 in the high one
+			const __m128i xLo = _mm_mullo_epi16(_mm_setr_epi16(0, 0, 0, 0, 1, 1, 1, 1), ho);
+			const __m128i xHi = _mm_mullo_epi16(_mm_setr_epi16(2, 2, 2, 2, 3, 3, 3, 3), ho);
+
+			__m128i y = _mm_set1_epi16(2);
+			for (uint32 j = 0; j < 4; j++)
+			{
+				__m128i lo = _mm_add_epi16(_mm_srai_epi16(_mm_add_epi16(xLo, y), 2), origin);
+				__m128i hi = _mm_add_epi16(_mm_srai_epi16(_mm_add_epi16(xHi, y), 2), origin);
+				rows[j] = _mm_packus_epi16(lo, hi);
+				y = _mm_add_epi16(y, vo);
+			}
+		}
+
+		static inline __m128i UnpackETC2Indices(const uint8* source)
+		{
+			return UnpackETC2Indices(_mm_loadl_epi64((const __m128i*)source));
+		}
+
+		//indices are UnpackETC2Indices(source), planar blocks ignore them
+		template<uint32 mode>
+		static inline void DecodeETC2BlockInMode(const uint8* source, __m128i indices, __m128i rows[4])
+		{
+			const ETC2Block* block = (const ETC2Block*)source;
+
+			uint32 paintColors[4];
+			switch (mode)
+			{
+			case ETC2Block::ModeT:
+				block->GetTModePaintColors(paintColors);
+				DecodePaintColors(paintColors, indices, rows);
+				break;
+			case ETC2Block::ModeH:
+				block->GetHModePaintColors(paintColors);
+				DecodePaintColors(paintColors, indices, rows);
+				break;
+			case ETC2Block::ModePlanar:
+				DecodePlanarMode(block, rows);
+				break;
+			default:
+				DecodeIndividualOrDifferentialMode(block, indices, rows);
+				break;
+			}
+		}
+
+		static inline void DecodeETC2Block(const uint8* source, __m128i indices, __m128i rows[4])
+		{
+			switch (((const ETC2Block*)source)->GetMode())
+			{
+			case ETC2Block::ModeT:
+				DecodeETC2BlockInMode<ETC2Block::ModeT>(source, indices, rows);
+				break;
+			case ETC2Block::ModeH:
+				DecodeETC2BlockInMode<ETC2Block::ModeH>(source, indices, rows);
+				break;
+			case ETC2Block::ModePlanar:
+				DecodeETC2BlockInMode<ETC2Block::ModePlanar>(source, indices, rows);
+				break;
+			default:
+				DecodeETC2BlockInMode<ETC2Block::ModeDifferential>(source, indices, rows);
+				break;
+			}
+		}
+
+		template<uint32 mode>
+		static inline void DecodeETC2BlockInMode(const uint8* source, __m128i rows[4])
+		{
+			DecodeETC2BlockInMode<mode>(source, UnpackETC2Indices(source), rows);
+		}
+
+		static inline void DecodeETC2Block(const uint8* source, __m128i rows[4])
+		{
+			DecodeETC2Block(source, UnpackETC2Indices(source), rows);
+		}
+
+		//See ETC2Block::DecodePunchThrough, opaque and planar blocks take the RGB8 paths
+		static inline void DecodePunchThroughBlock(const uint8* source, __m128i rows[4])
+		{
+			const ETC2Block* block = (const ETC2Block*)source;
+			const ETC2Block::Mode mode = block->GetPunchThroughMode();
+			if (mode == ETC2Block::ModePlanar || block->IsOpaque())
+			{
+				if (mode == ETC2Block::ModeT)
+					DecodeETC2BlockInMode<ETC2Block::ModeT>(source, rows);
+				else if (mode == ETC2Block::ModeH)
+					DecodeETC2BlockInMode<ETC2Block::ModeH>(source, rows);
+				else if (mode == ETC2Block::ModePlanar)
+					DecodeETC2BlockInMode<ETC2Block::ModePlanar>(source, rows);
+				else
+					DecodeETC2BlockInMode<ETC2Block::ModeDifferential>(source, rows);
+				return;
+			}
+
+			const __m128i blockBits = _mm_loadl_epi64((const __m128i*)source);
+			if (mode == ETC2Block::ModeDifferential)
+			{
+				uint32 color1, color2;
+				block->GetDifferentialBaseColors(color1, color2);
+				DecodeSubblocks(block, MakeNonOpaqueSubblockPalette(color1, block->GetTableIndex1()), MakeNonOpaqueSubblockPalette(color2, block->GetTableIndex2()), UnpackETC2Indices(blockBits), rows);
+				return;
+			}
+
+			uint32 paintColors[4];
+			if (mode == ETC2Block::ModeT)
+				block->GetTModePaintColors(paintColors);
+			else
+				block->GetHModePaintColors(paintColors);
+			paintColors[2] = 0;
+			DecodePaintColors(paintColors, UnpackETC2Indices(blockBits), rows);
+		}
+
+		//3 bit pixel indices of an EAC block, one byte per pixel in row-major order
+		static inline __m128i UnpackEACIndices(const uint8* source)
+		{
+			const __m128i blockBits = _mm_loadl_epi64((const __m128i*)source);
+
+			//the 48 index bits are big-endian in bytes 2..7, pixel (x, y) starts at bit 3*(x*4+y) from the top.
+			//gather the two bytes holding each index into a 16-bit lane, shift the index to the top by multiplying and take it from there
+			const __m128i windowLo = _mm_setr_epi8(3, 2, 4, 3, 6, 5, 7, 6, 3, 2, 4, 3, 6, 5, 7, 6);
+			const __m128i windowHi = _mm_setr_epi8(3, 2, 5, 4, 6, 5, (char)0x80, 7, 4, 3, 5, 4, 7, 6, (char)0x80, 7);
+			const __m128i shiftLo = _mm_setr_epi16(1, 16, 1, 16, 8, 128, 8, 128);
+			const __m128i shiftHi = _mm_setr_epi16(64, 4, 64, 4, 2, 32, 2, 32);
+
+			__m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(blockBits, windowLo), shiftLo), 13);
+			__m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(blockBits, windowHi), shiftHi), 13);
+			return _mm_packus_epi16(lo, hi);
+		}
+
+		//8 bit alpha of an EAC block, one byte per pixel in row-major order
+		static inline __m128i DecodeEACBlock(const uint8* source)
+		{
+			const int32 baseCodeword = source[0];
+			const int32 multiplier = source[1] >> 4;
+			const uint32 tableIdx = source[1] & 0xF;
+
+			__m128i palette = _mm_mullo_epi16(_mm_set1_epi16((int16)multiplier), _mm_load_si128((const __m128i*)modifierAlpha[tableIdx]));
+			palette = _mm_add_epi16(palette, _mm_set1_epi16((int16)baseCodeword));
+			palette = _mm_packus_epi16(palette, palette);
+
+			return _mm_shuffle_epi8(palette, UnpackEACIndices(source));
+		}
+
+		//The 8 values of an R11/RG11 channel block bit-replicated to 16 bits like Scalar::DecodeEACChannelRow,
+		//signed values are replicated on their magnitude
+		template<bool isSigned>
+		static inline __m128i GetEACChannelPalette(const uint8* source)
+		{
+			int32 base;
+			if (isSigned)
+			{
+				//-128 is not a valid signed base codeword and is treated as -127
+				base = (int8)source[0];
+				base = (base == -128 ? -127 : base) * 8;
+			}
+			else
+			{
+				base = source[0] * 8 + 4;
+			}
+			const int32 multiplier = source[1] >> 4;
+			const int32 scale = multiplier == 0 ? 1 : multiplier * 8;
+			const uint32 tableIdx = source[1] & 0xF;
+
+			__m128i palette = _mm_mullo_epi16(_mm_set1_epi16((int16)scale), _mm_load_si128((const __m128i*)modifierAlpha[tableIdx]));
+			palette = _mm_add_epi16(palette, _mm_set1_epi16((int16)base));
+			if (isSigned)
+			{
+				palette = _mm_min_epi16(_mm_max_epi16(palette, _mm_set1_epi16(-1023)), _mm_set1_epi16(1023));
+				const __m128i magnitude = _mm_abs_epi16(palette);
+				return _mm_sign_epi16(_mm_or_si128(_mm_slli_epi16(magnitude, 5), _mm_srli_epi16(magnitude, 5)), palette);
+			}
+			palette = _mm_min_epi16(_mm_max_epi16(palette, _mm_setzero_si128()), _mm_set1_epi16(2047));
+			return _mm_or_si128(_mm_slli_epi16(palette, 5), _mm_srli_epi16(palette, 6));
+		}
+
+		//One R11 channel: 16 bit values of rows 0-1 and rows 2-3, or the 8 bit values of all rows in values[0]
+		template<bool isSigned, bool is16Bits>
+		static inline void DecodeEACChannel(const uint8* source, __m128i values[2])
+		{
+			const __m128i palette = GetEACChannelPalette<isSigned>(source);
+			const __m128i indices = UnpackEACIndices(source);
+			if (is16Bits)
+			{
+				const __m128i indices2 = _mm_add_epi8(indices, indices);
+				const __m128i byteOffset = _mm_set1_epi16(0x0100);
+				values[0] = _mm_shuffle_epi8(palette, _mm_add_epi8(_mm_shuffle_epi8(indices2, _mm_setr_epi8(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7)), byteOffset));
+				values[1] = _mm_shuffle_epi8(palette, _mm_add_epi8(_mm_shuffle_epi8(indices2, _mm_setr_epi8(8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15)), byteOffset));
+			}
+			else if (isSigned)
+			{
+				//high byte rounded towards zero
+				const __m128i high = _mm_srai_epi16(_mm_add_epi16(palette, _mm_and_si128(_mm_srai_epi16(palette, 15), _mm_set1_epi16(255))), 8);
+				values[0] = _mm_shuffle_epi8(_mm_packs_epi16(high, high), indices);
+			}
+			else
+			{
+				const __m128i high = _mm_srli_epi16(palette, 8);
+				values[0] = _mm_shuffle_epi8(_mm_packus_epi16(high, high), indices);
+			}
+		}
+
+		//move the alpha of pixel row j into byte 3 of each RGBA8 pixel
+		static inline void MergeAlpha(__m128i rows[4], __m128i alpha)
+		{
+			const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+			rows[0] = _mm_blendv_epi8(rows[0], _mm_shuffle_epi8(alpha, _mm_setr_epi8(-1, -1, -1, 0, -1, -1, -1, 1, -1, -1, -1, 2, -1, -1, -1, 3)), alphaMask);
+			rows[1] = _mm_blendv_epi8(rows[1], _mm_shuffle_epi8(alpha, _mm_setr_epi8(-1, -1, -1, 4, -1, -1, -1, 5, -1, -1, -1, 6, -1, -1, -1, 7)), alphaMask);
+			rows[2] = _mm_blendv_epi8(rows[2], _mm_shuffle_epi8(alpha, _mm_setr_epi8(-1, -1, -1, 8, -1, -1, -1, 9, -1, -1, -1, 10, -1, -1, -1, 11)), alphaMask);
+			rows[3] = _mm_blendv_epi8(rows[3], _mm_shuffle_epi8(alpha, _mm_setr_epi8(-1, -1, -1, 12, -1, -1, -1, 13, -1, -1, -1, 14, -1, -1, -1, 15)), alphaMask);
+		}
+
+		static inline void StoreRows(uint8* dest, uint32 destRowPitch, const __m128i rows[4])
+		{
+			_mm_storeu_si128((__m128i*)dest, rows[0]);
+			_mm_storeu_si128((__m128i*)(dest + destRowPitch), rows[1]);
+			_mm_storeu_si128((__m128i*)(dest + destRowPitch * 2), rows[2]);
+			_mm_storeu_si128((__m128i*)(dest + destRowPitch * 3), rows[3]);
+		}
+
+		void DecodeETC2Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			uint32 i = 0;
+			for (; i + 4 <= blockCount; i += 4)
+			{
+				//the index unpacks of 4 blocks don't depend on each other or on the mode, issue them ahead of the mode branches
+				__m128i indices[4];
+				for (uint32 k = 0; k < 4; ++k)
+					indices[k] = UnpackETC2Indices(source + k * 8);
+				for (uint32 k = 0; k < 4; ++k)
+				{
+					__m128i rows[4];
+					DecodeETC2Block(source + k * 8, indices[k], rows);
+					StoreRows(dest + k * 16, destRowPitch, rows);
+				}
+
+				source += 32;
+				dest += 64;
+			}
+			for (; i < blockCount; ++i)
+			{
+				__m128i rows[4];
+				DecodeETC2Block(source, rows);
+				StoreRows(dest, destRowPitch, rows);
+
+				source += 8;
+				dest += 16;
+			}
+		}
+
+		void DecodeETC2A1Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				__m128i rows[4];
+				DecodePunchThroughBlock(source, rows);
+				StoreRows(dest, destRowPitch, rows);
+
+				source += 8;
+				dest += 16;
+			}
+		}
+
+		void DecodeETC2EACRow(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			uint32 i = 0;
+			for (; i + 4 <= blockCount; i += 4)
+			{
+				//as DecodeETC2Row, the alpha of all 4 blocks and their color indices first, then the mode dependent color
+				__m128i alpha[4], indices[4];
+				for (uint32 k = 0; k < 4; ++k)
+				{
+					alpha[k] = DecodeEACBlock(source + k * 16);
+					indices[k] = UnpackETC2Indices(source + k * 16 + 8);
+				}
+				for (uint32 k = 0; k < 4; ++k)
+				{
+					__m128i rows[4];
+					DecodeETC2Block(source + k * 16 + 8, indices[k], rows);
+					MergeAlpha(rows, alpha[k]);
+					StoreRows(dest + k * 16, destRowPitch, rows);
+				}
+
+				source += 64;
+				dest += 64;
+			}
+			for (; i < blockCount; ++i)
+			{
+				__m128i rows[4];
+				DecodeETC2Block(source + 8, rows);
+
+				MergeAlpha(rows, DecodeEACBlock(source));
+				StoreRows(dest, destRowPitch, rows);
+
+				source += 16;
+				dest += 16;
+			}
+		}
+
+		template<uint32 mode, bool withAlpha>
+		static void DecodeModeRun(const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count)
+		{
+			for (uint32 i = 0; i < count; ++i)
+			{
+				const uint8* block = source + blockIndices[i] * blockSize;
+
+				__m128i rows[4];
+				DecodeETC2BlockInMode<mode>(withAlpha ? block + 8 : block, rows);
+				if (withAlpha)
+					MergeAlpha(rows, DecodeEACBlock(block));
+				StoreRows(dest + blockIndices[i] * 16, destRowPitch, rows);
+			}
+		}
+
+		void DecodeETC2ModeRun(uint32 mode, const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count)
+		{
+			typedef void (*RunFunc)(const uint8* source, uint32 blockSize, uint8* dest, uint32 destRowPitch, const uint16* blockIndices, uint32 count);
+			static const RunFunc runs[2][5] =
+			{
+				{
+					DecodeModeRun<ETC2Block::ModeIndividual, false>, DecodeModeRun<ETC2Block::ModeDifferential, false>,
+					DecodeModeRun<ETC2Block::ModeT, false>, DecodeModeRun<ETC2Block::ModeH, false>, DecodeModeRun<ETC2Block::ModePlanar, false>,
+				},
+				{
+					DecodeModeRun<ETC2Block::ModeIndividual, true>, DecodeModeRun<ETC2Block::ModeDifferential, true>,
+					DecodeModeRun<ETC2Block::ModeT, true>, DecodeModeRun<ETC2Block::ModeH, true>, DecodeModeRun<ETC2Block::ModePlanar, true>,
+				},
+			};
+			runs[blockSize == 16][mode](source, blockSize, dest, destRowPitch, blockIndices, count);
+		}
+
+		static inline int32 HorizontalSum(__m128i v)
+		{
+			v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+			v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+			return _mm_cvtsi128_si32(v);
+		}
+
+		//Same choices as the scalar EncodeColorBlock in ETC_BC.cpp, made on the 16 decoded pixels instead of the block palette
+		template<uint32 format>
+		static inline void EncodeColorBlock(const __m128i rows[4], uint8* dest)
+		{
+			BC1Block& block = *(BC1Block*)dest;
+
+			__m128i minColor = _mm_min_epu8(_mm_min_epu8(rows[0], rows[1]), _mm_min_epu8(rows[2], rows[3]));
+			__m128i maxColor = _mm_max_epu8(_mm_max_epu8(rows[0], rows[1]), _mm_max_epu8(rows[2], rows[3]));
+			minColor = _mm_min_epu8(minColor, _mm_shuffle_epi32(minColor, _MM_SHUFFLE(1, 0, 3, 2)));
+			maxColor = _mm_max_epu8(maxColor, _mm_shuffle_epi32(maxColor, _MM_SHUFFLE(1, 0, 3, 2)));
+			minColor = _mm_min_epu8(minColor, _mm_shuffle_epi32(minColor, _MM_SHUFFLE(2, 3, 0, 1)));
+			maxColor = _mm_max_epu8(maxColor, _mm_shuffle_epi32(maxColor, _MM_SHUFFLE(2, 3, 0, 1)));
+			const uint32 minRGB = (uint32)_mm_cvtsi128_si32(minColor);
+			const uint32 maxRGB = (uint32)_mm_cvtsi128_si32(maxColor);
+
+			int32 start[3], direction[3];
+			int32 extent[3];
+			for (uint32 c = 0; c < 3; ++c)
+				extent[c] = (int32)((maxRGB >> (c * 8)) & 0xFF) - (int32)((minRGB >> (c * 8)) & 0xFF);
+			if ((extent[0] | extent[1] | extent[2]) == 0)
+			{
+				SetColorEndpoints<format>(minRGB | 0xFF000000, minRGB | 0xFF000000, block, start, direction);
+				return;
+			}
+
+			//16 R, G and B bytes
+			const __m128i planarCtrl = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+			const __m128i p0 = _mm_shuffle_epi8(rows[0], planarCtrl);
+			const __m128i p1 = _mm_shuffle_epi8(rows[1], planarCtrl);
+			const __m128i p2 = _mm_shuffle_epi8(rows[2], planarCtrl);
+			const __m128i p3 = _mm_shuffle_epi8(rows[3], planarCtrl);
+			const __m128i rg01 = _mm_unpacklo_epi32(p0, p1);
+			const __m128i rg23 = _mm_unpacklo_epi32(p2, p3);
+			const __m128i ba01 = _mm_unpackhi_epi32(p0, p1);
+			const __m128i ba23 = _mm_unpackhi_epi32(p2, p3);
+			const __m128i planes[3] = { _mm_unpacklo_epi64(rg01, rg23), _mm_unpackhi_epi64(rg01, rg23), _mm_unpacklo_epi64(ba01, ba23) };
+
+			const __m128i zero = _mm_setzero_si128();
+			int32 sum[3];
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				const __m128i s = _mm_sad_epu8(planes[c], zero);
+				sum[c] = _mm_cvtsi128_si32(s) + _mm_extract_epi16(s, 4);
+			}
+
+			const uint32 widest = GetWidestChannel(extent);
+			const __m128i widestLo = _mm_cvtepu8_epi16(planes[widest]);
+			const __m128i widestHi = _mm_unpackhi_epi8(planes[widest], zero);
+			int32 crossSums[3];
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				const __m128i products = _mm_add_epi32(_mm_madd_epi16(widestLo, _mm_cvtepu8_epi16(planes[c])), _mm_madd_epi16(widestHi, _mm_unpackhi_epi8(planes[c], zero)));
+				crossSums[c] = 16 * HorizontalSum(products) - sum[widest] * sum[c];
+			}
+
+			int32 axis[3];
+			GetBC1Axis(extent, crossSums, axis);
+
+			//projections of pixels 0..7 and 8..15 as int16, minpos finds the first smallest one in each half
+			const __m128i axisBytes = _mm_set1_epi32((axis[0] & 0xFF) | (axis[1] & 0xFF) << 8 | (axis[2] & 0xFF) << 16);
+			const __m128i projections0 = _mm_hadd_epi16(_mm_maddubs_epi16(rows[0], axisBytes), _mm_maddubs_epi16(rows[1], axisBytes));
+			const __m128i projections1 = _mm_hadd_epi16(_mm_maddubs_epi16(rows[2], axisBytes), _mm_maddubs_epi16(rows[3], axisBytes));
+			const __m128i toMin = _mm_set1_epi16((short)0x8000);
+			const __m128i toMax = _mm_set1_epi16(0x7FFF);
+			const uint32 min0 = (uint32)_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(projections0, toMin)));
+			const uint32 min1 = (uint32)_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(projections1, toMin)));
+			const uint32 max0 = (uint32)_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(projections0, toMax)));
+			const uint32 max1 = (uint32)_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(projections1, toMax)));
+			const uint32 minPixel = (min1 & 0xFFFF) < (min0 & 0xFFFF) ? 8 + ((min1 >> 16) & 0x7) : (min0 >> 16) & 0x7;
+			const uint32 maxPixel = (max1 & 0xFFFF) < (max0 & 0xFFFF) ? 8 + ((max1 >> 16) & 0x7) : (max0 >> 16) & 0x7;
+
+			uint32 pixels[16];
+			for (uint32 j = 0; j < 4; j++)
+				_mm_storeu_si128((__m128i*)(pixels + j * 4), rows[j]);
+
+			if (!SetColorEndpoints<format>(pixels[maxPixel], pixels[minPixel], block, start, direction))
+				return;
+
+			//t = (pixel - start) . direction, the step is how many of the midpoint thresholds (times length^2) scale * t passes
+			const ColorBlockSteps& colorSteps = colorBlockSteps[format];
+			const int32 length2 = direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2];
+			const __m128i start16 = _mm_setr_epi16((short)start[0], (short)start[1], (short)start[2], 0, (short)start[0], (short)start[1], (short)start[2], 0);
+			const __m128i direction16 = _mm_setr_epi16((short)direction[0], (short)direction[1], (short)direction[2], 0, (short)direction[0], (short)direction[1], (short)direction[2], 0);
+			const __m128i threshold0 = _mm_set1_epi32(colorSteps.thresholds[0] * length2);
+			const __m128i threshold1 = _mm_set1_epi32(colorSteps.thresholds[1] * length2);
+			const __m128i threshold2 = _mm_set1_epi32(colorSteps.thresholds[2] * length2);
+			__m128i steps[4];
+			for (uint32 j = 0; j < 4; j++)
+			{
+				const __m128i lo = _mm_sub_epi16(_mm_cvtepu8_epi16(rows[j]), start16);
+				const __m128i hi = _mm_sub_epi16(_mm_unpackhi_epi8(rows[j], zero), start16);
+				const __m128i t = _mm_hadd_epi32(_mm_madd_epi16(lo, direction16), _mm_madd_epi16(hi, direction16));
+				//scale is 6 or 16
+				const __m128i scaled = format == ColorBlockBC1 ? _mm_add_epi32(_mm_slli_epi32(t, 2), _mm_slli_epi32(t, 1)) : _mm_slli_epi32(t, 4);
+				const __m128i passed = _mm_add_epi32(_mm_add_epi32(_mm_cmpgt_epi32(scaled, threshold0), _mm_cmpgt_epi32(scaled, threshold1)), _mm_cmpgt_epi32(scaled, threshold2));
+				steps[j] = _mm_sub_epi32(zero, passed);
+			}
+			__m128i indices = _mm_packs_epi16(_mm_packs_epi32(steps[0], steps[1]), _mm_packs_epi32(steps[2], steps[3]));
+			indices = _mm_shuffle_epi8(_mm_cvtsi32_si128(colorSteps.stepToIndex[0] | colorSteps.stepToIndex[1] << 8 | colorSteps.stepToIndex[2] << 16 | colorSteps.stepToIndex[3] << 24), indices);
+
+			//16 2 bit indices into 32 bits
+			indices = _mm_maddubs_epi16(indices, _mm_set1_epi16(0x0401));
+			indices = _mm_madd_epi16(indices, _mm_set1_epi32(0x00100001));
+			indices = _mm_shuffle_epi8(indices, _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+			block.indices = (uint32)_mm_cvtsi128_si32(indices);
+		}
+
+		//16 alpha bytes in row-major order to a BC3 alpha block, same choices as the scalar EncodeBC3AlphaBlock
+		static inline void EncodeBC3AlphaBlock(__m128i alpha, uint8* dest)
+		{
+			BC3AlphaBlock& bc3 = *(BC3AlphaBlock*)dest;
+
+			__m128i minAlpha = _mm_min_epu8(alpha, _mm_srli_si128(alpha, 8));
+			__m128i maxAlpha = _mm_max_epu8(alpha, _mm_srli_si128(alpha, 8));
+			minAlpha = _mm_min_epu8(minAlpha, _mm_srli_si128(minAlpha, 4));
+			maxAlpha = _mm_max_epu8(maxAlpha, _mm_srli_si128(maxAlpha, 4));
+			minAlpha = _mm_min_epu8(minAlpha, _mm_srli_si128(minAlpha, 2));
+			maxAlpha = _mm_max_epu8(maxAlpha, _mm_srli_si128(maxAlpha, 2));
+			minAlpha = _mm_min_epu8(minAlpha, _mm_srli_si128(minAlpha, 1));
+			maxAlpha = _mm_max_epu8(maxAlpha, _mm_srli_si128(maxAlpha, 1));
+			const uint32 minValue = (uint32)_mm_cvtsi128_si32(minAlpha) & 0xFF;
+			const uint32 maxValue = (uint32)_mm_cvtsi128_si32(maxAlpha) & 0xFF;
+
+			bc3.alpha0 = (uint8)maxValue;
+			bc3.alpha1 = (uint8)minValue;
+			if (maxValue == minValue)
+			{
+				bc3.SetIndices(0);
+				return;
+			}
+
+			//step 0..7 from alpha1 to alpha0 in 16.16 fixed point
+			const __m128i scale = _mm_set1_epi32((7 << 16) / (maxValue - minValue));
+			const __m128i offset = _mm_set1_epi32((int)minValue);
+			const __m128i half = _mm_set1_epi32(0x8000);
+			const __m128i maxStep = _mm_set1_epi32(7);
+			const __m128i values[4] =
+			{
+				_mm_sub_epi32(_mm_cvtepu8_epi32(alpha), offset),
+				_mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(alpha, 4)), offset),
+				_mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(alpha, 8)), offset),
+				_mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(alpha, 12)), offset),
+			};
+			__m128i steps[4];
+			for (uint32 j = 0; j < 4; j++)
+				steps[j] = _mm_min_epi32(_mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(values[j], scale), half), 16), maxStep);
+			__m128i indices = _mm_packus_epi16(_mm_packus_epi32(steps[0], steps[1]), _mm_packus_epi32(steps[2], steps[3]));
+			indices = _mm_shuffle_epi8(_mm_setr_epi8(1, 7, 6, 5, 4, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0), indices);
+
+			//16 3 bit indices, 12 bits per 4 pixels
+			indices = _mm_maddubs_epi16(indices, _mm_set1_epi16(0x0801));
+			indices = _mm_madd_epi16(indices, _mm_set1_epi32(0x00400001));
+			const uint64 indexBits = (uint64)(uint32)_mm_cvtsi128_si32(indices) | (uint64)(uint32)_mm_extract_epi32(indices, 1) << 12
+				| (uint64)(uint32)_mm_extract_epi32(indices, 2) << 24 | (uint64)(uint32)_mm_extract_epi32(indices, 3) << 36;
+			bc3.SetIndices(indexBits);
+		}
+
+		template<uint32 format>
+		static void TranscodeETC2ToColorBlocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				__m128i rows[4];
+				DecodeETC2Block(source, rows);
+				EncodeColorBlock<format>(rows, dest);
+
+				source += 8;
+				dest += 8;
+			}
+		}
+
+		template<uint32 format>
+		static void TranscodeETC2EACToAlphaColorBlocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				EncodeBC3AlphaBlock(DecodeEACBlock(source), dest);
+
+				__m128i rows[4];
+				DecodeETC2Block(source + 8, rows);
+				EncodeColorBlock<format>(rows, dest + 8);
+
+				source += 16;
+				dest += 16;
+			}
+		}
+
+		void TranscodeETC2ToBC1Blocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			TranscodeETC2ToColorBlocks<ColorBlockBC1>(source, dest, blockCount);
+		}
+
+		void TranscodeETC2EACToBC3Blocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			TranscodeETC2EACToAlphaColorBlocks<ColorBlockBC1>(source, dest, blockCount);
+		}
+
+		void TranscodeETC2ToATCBlocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			TranscodeETC2ToColorBlocks<ColorBlockATC>(source, dest, blockCount);
+		}
+
+		void TranscodeETC2EACToATCBlocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			TranscodeETC2EACToAlphaColorBlocks<ColorBlockATC>(source, dest, blockCount);
+		}
+
+		//The 4 RGBA8 colors of a BC1 color block, same values as BC1Block::GetColors
+		template<bool isBC1>
+		static inline __m128i GetBC1Colors(const uint8* source)
+		{
+			const BC1Block& block = *(const BC1Block*)source;
+			const __m128i ends = _mm_cvtepu8_epi16(_mm_setr_epi32((int)UnpackRGB565(block.color0), (int)UnpackRGB565(block.color1), 0, 0));
+			const __m128i swapped = _mm_shuffle_epi32(ends, _MM_SHUFFLE(1, 0, 3, 2));
+
+			//(2 * c0 + c1) / 3 and (c0 + 2 * c1) / 3, x * 0xAAAB >> 17 is x / 3 for these sums
+			const __m128i thirds = _mm_srli_epi16(_mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(ends, ends), swapped), _mm_set1_epi16((short)0xAAAB)), 1);
+			const __m128i fourColors = _mm_packus_epi16(ends, thirds);
+			if (!isBC1)
+				return fourColors;
+
+			//(c0 + c1) / 2 and transparent black
+			const __m128i half = _mm_srli_epi16(_mm_add_epi16(ends, swapped), 1);
+			const __m128i threeColors = _mm_packus_epi16(ends, _mm_move_epi64(half));
+			return _mm_blendv_epi8(fourColors, threeColors, _mm_set1_epi8(block.color0 > block.color1 ? 0 : -1));
+		}
+
+		//Pick the colors of the 16 pixels, 2 bit indices in row-major order
+		static inline void DecodeBC1Indices(__m128i colors, uint32 indices, __m128i rows[4])
+		{
+			//byte p holds the index byte of pixel p, testing its two bits gives index * 4, the offset of its color
+			const __m128i bytes = _mm_shuffle_epi8(_mm_cvtsi32_si128((int)indices), _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3));
+			const __m128i lsbMask = _mm_setr_epi8(1, 4, 16, 64, 1, 4, 16, 64, 1, 4, 16, 64, 1, 4, 16, 64);
+			const __m128i msbMask = _mm_setr_epi8(2, 8, 32, (char)128, 2, 8, 32, (char)128, 2, 8, 32, (char)128, 2, 8, 32, (char)128);
+			const __m128i lsb = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(bytes, lsbMask), lsbMask), _mm_set1_epi8(4));
+			const __m128i msb = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(bytes, msbMask), msbMask), _mm_set1_epi8(8));
+			const __m128i offsets = _mm_or_si128(lsb, msb);
+
+			const __m128i channels = _mm_set1_epi32(0x03020100);
+			rows[0] = _mm_shuffle_epi8(colors, _mm_add_epi8(_mm_shuffle_epi8(offsets, _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3)), channels));
+			rows[1] = _mm_shuffle_epi8(colors, _mm_add_epi8(_mm_shuffle_epi8(offsets, _mm_setr_epi8(4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7)), channels));
+			rows[2] = _mm_shuffle_epi8(colors, _mm_add_epi8(_mm_shuffle_epi8(offsets, _mm_setr_epi8(8, 8, 8, 8, 9, 9, 9, 9, 10, 10, 10, 10, 11, 11, 11, 11)), channels));
+			rows[3] = _mm_shuffle_epi8(colors, _mm_add_epi8(_mm_shuffle_epi8(offsets, _mm_setr_epi8(12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15)), channels));
+		}
+
+		//8 bit alpha of a BC3 alpha block, one byte per pixel in row-major order
+		static inline __m128i DecodeBC3AlphaBlock(const uint8* source)
+		{
+			const __m128i blockBits = _mm_loadl_epi64((const __m128i*)source);
+
+			//8 interpolated values divided by 7, or 6 divided by 5 followed by 0 and 255, x * 9363 >> 16 and x * 13108 >> 16
+			//are exact for these sums
+			const __m128i alpha0 = _mm_set1_epi16(source[0]);
+			const __m128i alpha1 = _mm_set1_epi16(source[1]);
+			const __m128i eighths = _mm_add_epi16(_mm_mullo_epi16(alpha0, _mm_setr_epi16(7, 0, 6, 5, 4, 3, 2, 1)), _mm_mullo_epi16(alpha1, _mm_setr_epi16(0, 7, 1, 2, 3, 4, 5, 6)));
+			const __m128i sixths = _mm_add_epi16(_mm_mullo_epi16(alpha0, _mm_setr_epi16(5, 0, 4, 3, 2, 1, 0, 0)), _mm_mullo_epi16(alpha1, _mm_setr_epi16(0, 5, 1, 2, 3, 4, 0, 0)));
+			const __m128i eightValues = _mm_mulhi_epu16(eighths, _mm_set1_epi16(9363));
+			const __m128i sixValues = _mm_or_si128(_mm_mulhi_epu16(sixths, _mm_set1_epi16(13108)), _mm_setr_epi16(0, 0, 0, 0, 0, 0, 0, 255));
+			__m128i palette = source[0] > source[1] ? eightValues : sixValues;
+			palette = _mm_packus_epi16(palette, palette);
+
+			//the 48 index bits are little-endian in bytes 2..7, pixel p starts at bit 3 * p.
+			//gather the two bytes holding each index into a 16-bit lane, shift the index to the top by multiplying and take it from there
+			const __m128i windowLo = _mm_setr_epi8(2, 3, 2, 3, 2, 3, 3, 4, 3, 4, 3, 4, 4, 5, 4, 5);
+			const __m128i windowHi = _mm_setr_epi8(5, 6, 5, 6, 5, 6, 6, 7, 6, 7, 6, 7, 7, (char)0x80, 7, (char)0x80);
+			const __m128i shift = _mm_setr_epi16(8192, 1024, 128, 4096, 512, 64, 2048, 256);
+
+			const __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(blockBits, windowLo), shift), 13);
+			const __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(blockBits, windowHi), shift), 13);
+
+			return _mm_shuffle_epi8(palette, _mm_packus_epi16(lo, hi));
+		}
+
+		template<bool isSigned, uint32 channels, bool is16Bits>
+		static void DecodeEACChannelRow(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			const uint32 pixelSize = channels * (is16Bits ? 2 : 1);
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				__m128i red[2], green[2];
+				DecodeEACChannel<isSigned, is16Bits>(source, red);
+				if (channels == 2)
+					DecodeEACChannel<isSigned, is16Bits>(source + 8, green);
+
+				if (channels == 2 && is16Bits)
+				{
+					_mm_storeu_si128((__m128i*)dest, _mm_unpacklo_epi16(red[0], green[0]));
+					_mm_storeu_si128((__m128i*)(dest + destRowPitch), _mm_unpackhi_epi16(red[0], green[0]));
+					_mm_storeu_si128((__m128i*)(dest + destRowPitch * 2), _mm_unpacklo_epi16(red[1], green[1]));
+					_mm_storeu_si128((__m128i*)(dest + destRowPitch * 3), _mm_unpackhi_epi16(red[1], green[1]));
+				}
+				else if (channels == 2 || is16Bits)
+				{
+					//8 bytes per row
+					const __m128i rows01 = channels == 2 ? _mm_unpacklo_epi8(red[0], green[0]) : red[0];
+					const __m128i rows23 = channels == 2 ? _mm_unpackhi_epi8(red[0], green[0]) : red[1];
+					_mm_storel_epi64((__m128i*)dest, rows01);
+					_mm_storel_epi64((__m128i*)(dest + destRowPitch), _mm_srli_si128(rows01, 8));
+					_mm_storel_epi64((__m128i*)(dest + destRowPitch * 2), rows23);
+					_mm_storel_epi64((__m128i*)(dest + destRowPitch * 3), _mm_srli_si128(rows23, 8));
+				}
+				else
+				{
+					//4 bytes per row, rows of narrow images aren't 4 byte aligned
+					const int32 rows[4] = { _mm_cvtsi128_si32(red[0]), _mm_extract_epi32(red[0], 1), _mm_extract_epi32(red[0], 2), _mm_extract_epi32(red[0], 3) };
+					for (uint32 j = 0; j < 4; ++j)
+						memcpy(dest + j * destRowPitch, &rows[j], 4);
+				}
+
+				source += channels * 8;
+				dest += pixelSize * 4;
+			}
+		}
+
+		const DecodeRowFunc decodeEACChannelRows[8] =
+		{
+			DecodeEACChannelRow<false, 1, false>, DecodeEACChannelRow<false, 1, true>, DecodeEACChannelRow<false, 2, false>, DecodeEACChannelRow<false, 2, true>,
+			DecodeEACChannelRow<true, 1, false>, DecodeEACChannelRow<true, 1, true>, DecodeEACChannelRow<true, 2, false>, DecodeEACChannelRow<true, 2, true>,
+		};
+
+		void DecodeBC1Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				__m128i rows[4];
+				DecodeBC1Indices(GetBC1Colors<true>(source), ((const BC1Block*)source)->indices, rows);
+				StoreRows(dest, destRowPitch, rows);
+
+				source += 8;
+				dest += 16;
+			}
+		}
+
+		void DecodeBC3Row(const uint8* source, uint8* dest, uint32 destRowPitch, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				__m128i rows[4];
+				DecodeBC1Indices(GetBC1Colors<false>(source + 8), ((const BC1Block*)(source + 8))->indices, rows);
+
+				MergeAlpha(rows, DecodeBC3AlphaBlock(source));
+				StoreRows(dest, destRowPitch, rows);
+
+				source += 16;
+				dest += 16;
+			}
+		}
+
+		//The modifiers of table t are 3 * m0 and 3 * m1 in luminance offsets. Twice the distance from an absolute offset to
+		//the closer one is | |2 * offset - (3 * m0 + 3 * m1)| - (3 * m1 - 3 * m0) |, squared the outer abs isn't needed.
+		static inline __m128i GetDoubledFastDistances(__m128i doubledOffsets, uint32 t)
+		{
+			const int32* modifiers = intensityModifierDefault[t];
+			const __m128i centers = _mm_set1_epi16((int16)(3 * (modifiers[0] + modifiers[1])));
+			const __m128i spans = _mm_set1_epi16((int16)(3 * (modifiers[1] - modifiers[0])));
+			return _mm_sub_epi16(_mm_abs_epi16(_mm_sub_epi16(doubledOffsets, centers)), spans);
+		}
+
+		//The table of both subblocks from twice the absolute luminance offsets of their 8 pixels. The squared errors of
+		//every table are summed up shifted by 3 with the table in the low bits, so the smallest key is the first table
+		//with the smallest error. 4 * 8 * 765^2 < 2^25 keeps the keys in 28 bits.
+		static inline void FindFastTables(__m128i doubledOffsets0, __m128i doubledOffsets1, uint32 tables[2])
+		{
+			//subblock 0 pixels 0-3, 4-7, subblock 1 pixels 0-3, 4-7 for every table
+			__m128i errors[8];
+			for (uint32 t = 0; t < 8; ++t)
+			{
+				const __m128i distances0 = GetDoubledFastDistances(doubledOffsets0, t);
+				const __m128i distances1 = GetDoubledFastDistances(doubledOffsets1, t);
+				errors[t] = _mm_hadd_epi32(_mm_madd_epi16(distances0, distances0), _mm_madd_epi16(distances1, distances1));
+			}
+			//subblock 0 and 1 of table t, then of table t + 1
+			__m128i keys = _mm_min_epi32(
+				_mm_min_epi32(_mm_or_si128(_mm_slli_epi32(_mm_hadd_epi32(errors[0], errors[1]), 3), _mm_setr_epi32(0, 0, 1, 1)),
+					_mm_or_si128(_mm_slli_epi32(_mm_hadd_epi32(errors[2], errors[3]), 3), _mm_setr_epi32(2, 2, 3, 3))),
+				_mm_min_epi32(_mm_or_si128(_mm_slli_epi32(_mm_hadd_epi32(errors[4], errors[5]), 3), _mm_setr_epi32(4, 4, 5, 5)),
+					_mm_or_si128(_mm_slli_epi32(_mm_hadd_epi32(errors[6], errors[7]), 3), _mm_setr_epi32(6, 6, 7, 7))));
+			keys = _mm_min_epi32(keys, _mm_shuffle_epi32(keys, _MM_SHUFFLE(1, 0, 3, 2)));
+			tables[0] = (uint32)_mm_cvtsi128_si32(keys) & 7;
+			tables[1] = (uint32)_mm_extract_epi32(keys, 1) & 7;
+		}
+
+		//-1 in the 16-bit lanes whose pixel takes the large modifier of table, the ones past the middle of the two
+		static inline __m128i GetFastSelectorLsb(__m128i doubledOffsets, uint32 table)
+		{
+			const int32* modifiers = intensityModifierDefault[table];
+			return _mm_cmpgt_epi16(doubledOffsets, _mm_set1_epi16((int16)(3 * (modifiers[0] + modifiers[1]))));
+		}
+
+		//Same blocks as the scalar fast preset without branches: the channel sums of both splits take one pshufb and maddubs
+		//per row and sit in the 16-bit lanes R, G, B, A of subblock 0 followed by subblock 1, so the flip, the base colors and
+		//the mode are picked on both subblocks at once. The luminance offsets of each subblock fill 8 lanes and the 8 tables
+		//are scored on them side by side.
+		void EncodeETC1FastRow(const uint8* source, uint32 sourceRowPitch, uint8* dest, uint32 blockCount)
+		{
+			const __m128i planarCtrl = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+			const __m128i leftRightCtrl = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+			const __m128i ones = _mm_set1_epi8(1);
+			const __m128i rgbOnes = _mm_set1_epi32(0x00010101);
+			const __m128i rgbMask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+			//the selector masks of both subblocks back in ETC order, k = x * 4 + y
+			const __m128i leftRightOrder = _mm_setr_epi8(0, 2, 4, 6, 1, 3, 5, 7, 8, 10, 12, 14, 9, 11, 13, 15);
+			const __m128i topBottomOrder = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				__m128i rows[4];
+				for (uint32 y = 0; y < 4; ++y)
+					rows[y] = _mm_loadu_si128((const __m128i*)(source + y * sourceRowPitch));
+
+				//per row R01, R23, G01, G23, B01, B23, A01, A23
+				__m128i halves[4];
+				for (uint32 y = 0; y < 4; ++y)
+					halves[y] = _mm_maddubs_epi16(_mm_shuffle_epi8(rows[y], planarCtrl), ones);
+				const __m128i top = _mm_add_epi16(halves[0], halves[1]);
+				const __m128i bottom = _mm_add_epi16(halves[2], halves[3]);
+				const __m128i leftRight = _mm_shuffle_epi8(_mm_add_epi16(top, bottom), leftRightCtrl);
+				const __m128i topBottom = _mm_hadd_epi16(top, bottom);
+
+				//the flip whose halves explain more, the sum of their squared channel sums
+				const __m128i leftRightRGB = _mm_and_si128(leftRight, rgbMask);
+				const __m128i topBottomRGB = _mm_and_si128(topBottom, rgbMask);
+				__m128i explained = _mm_hadd_epi32(_mm_madd_epi16(leftRightRGB, leftRightRGB), _mm_madd_epi16(topBottomRGB, topBottomRGB));
+				explained = _mm_hadd_epi32(explained, explained);
+				const __m128i flipMask = _mm_cmpgt_epi32(_mm_shuffle_epi32(explained, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_epi32(explained, _MM_SHUFFLE(0, 0, 0, 0)));
+				const uint32 flip = (uint32)_mm_cvtsi128_si32(flipMask) & 1;
+
+				//QuantizeETC1BaseColors, x / 255 is (x + 1) * 257 >> 16 for x < 8100
+				const __m128i means = _mm_srli_epi16(_mm_add_epi16(_mm_blendv_epi8(leftRight, topBottom, flipMask), _mm_set1_epi16(4)), 3);
+				const __m128i bases5 = _mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(means, _mm_set1_epi16(31)), _mm_set1_epi16(128)), _mm_set1_epi16(257));
+				const __m128i bases4 = _mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(means, _mm_set1_epi16(15)), _mm_set1_epi16(128)), _mm_set1_epi16(257));
+				const __m128i deltas = _mm_sub_epi16(_mm_srli_si128(bases5, 8), bases5);
+				const __m128i inRange = _mm_and_si128(_mm_cmpgt_epi16(deltas, _mm_set1_epi16(-5)), _mm_cmplt_epi16(deltas, _mm_set1_epi16(4)));
+				const bool differential = (_mm_movemask_epi8(inRange) & 0x3F) == 0x3F;
+
+				__m128i baseColors, header;
+				if (differential)
+				{
+					baseColors = _mm_or_si128(_mm_slli_epi16(bases5, 3), _mm_srli_epi16(bases5, 2));
+					header = _mm_or_si128(_mm_slli_epi16(bases5, 3), _mm_and_si128(deltas, _mm_set1_epi16(0x7)));
+				}
+				else
+				{
+					baseColors = _mm_or_si128(_mm_slli_epi16(bases4, 4), bases4);
+					header = _mm_or_si128(_mm_slli_epi16(bases4, 4), _mm_srli_si128(bases4, 8));
+				}
+				//R + G + B of both base colors in all lanes
+				__m128i baseSums = _mm_madd_epi16(_mm_and_si128(baseColors, rgbMask), _mm_set1_epi16(1));
+				baseSums = _mm_hadd_epi32(baseSums, baseSums);
+				baseSums = _mm_packs_epi32(baseSums, baseSums);
+
+				//R + G + B of every pixel, rows 0-1 and rows 2-3 in row-major order, or columns 0-1 and columns 2-3 of rows 0..3
+				const __m128i pixelSumsTop = _mm_hadd_epi16(_mm_maddubs_epi16(rows[0], rgbOnes), _mm_maddubs_epi16(rows[1], rgbOnes));
+				const __m128i pixelSumsBottom = _mm_hadd_epi16(_mm_maddubs_epi16(rows[2], rgbOnes), _mm_maddubs_epi16(rows[3], rgbOnes));
+				const __m128i topColumns = _mm_shuffle_epi32(pixelSumsTop, _MM_SHUFFLE(3, 1, 2, 0));
+				const __m128i bottomColumns = _mm_shuffle_epi32(pixelSumsBottom, _MM_SHUFFLE(3, 1, 2, 0));
+				const __m128i offsets[2] =
+				{
+					_mm_sub_epi16(_mm_blendv_epi8(_mm_unpacklo_epi64(topColumns, bottomColumns), pixelSumsTop, flipMask), _mm_shuffle_epi8(baseSums, _mm_set1_epi16(0x0100))),
+					_mm_sub_epi16(_mm_blendv_epi8(_mm_unpackhi_epi64(topColumns, bottomColumns), pixelSumsBottom, flipMask), _mm_shuffle_epi8(baseSums, _mm_set1_epi16(0x0302))),
+				};
+
+				const __m128i doubledOffsets[2] = { _mm_slli_epi16(_mm_abs_epi16(offsets[0]), 1), _mm_slli_epi16(_mm_abs_epi16(offsets[1]), 1) };
+				uint32 tables[2];
+				FindFastTables(doubledOffsets[0], doubledOffsets[1], tables);
+				const __m128i lsb[2] = { GetFastSelectorLsb(doubledOffsets[0], tables[0]), GetFastSelectorLsb(doubledOffsets[1], tables[1]) };
+				const __m128i etcOrder = _mm_blendv_epi8(leftRightOrder, topBottomOrder, flipMask);
+				const uint32 lsbBits = (uint32)_mm_movemask_epi8(_mm_shuffle_epi8(_mm_packs_epi16(lsb[0], lsb[1]), etcOrder));
+				const uint32 msbBits = (uint32)_mm_movemask_epi8(_mm_shuffle_epi8(_mm_packs_epi16(offsets[0], offsets[1]), etcOrder));
+
+				const uint32 headerBits = ((uint32)_mm_cvtsi128_si32(_mm_packus_epi16(header, header)) & 0xFFFFFF) | (tables[0] << 5 | tables[1] << 2 | (differential ? 2 : 0) | flip) << 24;
+				const uint32 selectorBits = msbBits >> 8 | (msbBits & 0xFF) << 8 | (lsbBits >> 8) << 16 | (lsbBits & 0xFF) << 24;
+				_mm_storel_epi64((__m128i*)dest, _mm_insert_epi32(_mm_cvtsi32_si128((int)headerBits), (int)selectorBits, 1));
+
+				source += 16;
+				dest += 8;
+			}
+		}
+
+		//Squared distances from a color to one palette entry of every table, tables 0-3 and 4-7 in 32-bit lanes
+		static inline void GetSquaredDistances(const __m128i palette[3], const __m128i color[3], __m128i distances[2])
+		{
+			const __m128i r = _mm_sub_epi16(palette[0], color[0]);
+			const __m128i g = _mm_sub_epi16(palette[1], color[1]);
+			const __m128i b = _mm_sub_epi16(palette[2], color[2]);
+			const __m128i rgLo = _mm_unpacklo_epi16(r, g);
+			const __m128i rgHi = _mm_unpackhi_epi16(r, g);
+			const __m128i bLo = _mm_unpacklo_epi16(b, _mm_setzero_si128());
+			const __m128i bHi = _mm_unpackhi_epi16(b, _mm_setzero_si128());
+			distances[0] = _mm_add_epi32(_mm_madd_epi16(rgLo, rgLo), _mm_madd_epi16(bLo, bLo));
+			distances[1] = _mm_add_epi32(_mm_madd_epi16(rgHi, rgHi), _mm_madd_epi16(bHi, bHi));
+		}
+
+		//Same fit as the scalar FitETC1Subblock for the 4 colors of a BC1 block, the 8 tables scored side by side. Both
+		//modifiers on the side of a color are measured with clamping, which the scalar no-clamp formula equals when
+		//nothing clamps, so every table gets the same error and selectors. Colors without weight are scored too and add
+		//nothing. The errors are keyed like FindFastTables, 16 * 3 * 255^2 < 2^22 keeps them in 25 bits.
+		static inline void FitETC1Subblock(uint32 baseColor, const uint32 colors[4], const uint32 weights[4], ETC1SubblockFit& fit)
+		{
+			//palettes[m][c]: channel c of base + modifier m of every table, clamped
+			__m128i palettes[4][3];
+			int32 baseSum = 0;
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				const int32 channel = (baseColor >> (c * 8)) & 0xFF;
+				baseSum += channel;
+				for (uint32 m = 0; m < 4; ++m)
+				{
+					const __m128i sum = _mm_add_epi16(_mm_set1_epi16((int16)channel), _mm_load_si128((const __m128i*)modifierColumns[m]));
+					palettes[m][c] = _mm_min_epi16(_mm_max_epi16(sum, _mm_setzero_si128()), _mm_set1_epi16(255));
+				}
+			}
+
+			__m128i errors[2] = { _mm_setzero_si128(), _mm_setzero_si128() };
+			uint32 largeBits[4] = {};
+			uint32 sides[4];
+			for (uint32 e = 0; e < 4; ++e)
+			{
+				__m128i color[3];
+				int32 sum = -baseSum;
+				for (uint32 c = 0; c < 3; ++c)
+				{
+					const int32 channel = (colors[e] >> (c * 8)) & 0xFF;
+					color[c] = _mm_set1_epi16((int16)channel);
+					sum += channel;
+				}
+				sides[e] = sum < 0 ? 2 : 0;
+
+				__m128i distances0[2], distances1[2];
+				GetSquaredDistances(palettes[sides[e]], color, distances0);
+				GetSquaredDistances(palettes[sides[e] + 1], color, distances1);
+				const __m128i weight = _mm_set1_epi32((int)weights[e]);
+				for (uint32 h = 0; h < 2; ++h)
+				{
+					const __m128i large = _mm_cmpgt_epi32(distances0[h], distances1[h]);
+					largeBits[e] |= (uint32)_mm_movemask_ps(_mm_castsi128_ps(large)) << (h * 4);
+					errors[h] = _mm_add_epi32(errors[h], _mm_mullo_epi32(_mm_min_epi32(distances0[h], distances1[h]), weight));
+				}
+			}
+
+			__m128i keys = _mm_min_epi32(_mm_or_si128(_mm_slli_epi32(errors[0], 3), _mm_setr_epi32(0, 1, 2, 3)),
+				_mm_or_si128(_mm_slli_epi32(errors[1], 3), _mm_setr_epi32(4, 5, 6, 7)));
+			keys = _mm_min_epi32(keys, _mm_shuffle_epi32(keys, _MM_SHUFFLE(1, 0, 3, 2)));
+			keys = _mm_min_epi32(keys, _mm_shuffle_epi32(keys, _MM_SHUFFLE(2, 3, 0, 1)));
+			const uint32 key = (uint32)_mm_cvtsi128_si32(keys);
+
+			fit.table = key & 7;
+			fit.error = key >> 3;
+			for (uint32 e = 0; e < 4; ++e)
+				fit.selectors[e] = (uint8)(weights[e] ? sides[e] + ((largeBits[e] >> fit.table) & 1) : 0);
+		}
+
+		//(sum + total / 2) / total of the channel sums of both subblocks in the 16-bit lanes R, G, B, A of subblock 0 followed
+		//by subblock 1, into R, G, B of means[subblock]. The alpha sum is 255 per opaque pixel and transparent pixels are
+		//black, so total counts the pixels that have weight. Quotients of numbers below 2^12 are exact in float.
+		static inline void GetSubblockMeans(__m128i sums, int32 means[2][4])
+		{
+			//x / 255 is (x + 1) * 257 >> 16 for x < 8100
+			const __m128i counts = _mm_mulhi_epu16(_mm_add_epi16(sums, _mm_set1_epi16(1)), _mm_set1_epi16(257));
+			const __m128i totals = _mm_shuffle_epi8(counts, _mm_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15));
+			const __m128i numerators = _mm_add_epi16(sums, _mm_srli_epi16(totals, 1));
+			const __m128i divisors = _mm_max_epi16(totals, _mm_set1_epi16(1));
+			const __m128 quotients[2] =
+			{
+				_mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(numerators)), _mm_cvtepi32_ps(_mm_cvtepu16_epi32(divisors))),
+				_mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(numerators, _mm_setzero_si128())), _mm_cvtepi32_ps(_mm_unpackhi_epi16(divisors, _mm_setzero_si128()))),
+			};
+			_mm_storeu_si128((__m128i*)means[0], _mm_cvttps_epi32(quotients[0]));
+			_mm_storeu_si128((__m128i*)means[1], _mm_cvttps_epi32(quotients[1]));
+		}
+
+		//Same blocks as the scalar EncodeETC1Block in BC_ETC.cpp with the fit above. The means come from the channel sums
+		//of the decoded pixels like in EncodeETC1FastRow instead of the weighted palette.
+		static inline void EncodeETC1Block(const uint8* source, uint8* dest)
+		{
+			const BC1Block& bc1 = *(const BC1Block*)source;
+			const __m128i colorBytes = GetBC1Colors<true>(source);
+			uint32 colors[4];
+			_mm_storeu_si128((__m128i*)colors, colorBytes);
+			const bool hasTransparent = bc1.color0 <= bc1.color1;
+
+			//weights[flip][subblock][entry], subblock 1 is x >= 2 or, flipped, y >= 2
+			uint32 weights[2][2][4] = {};
+			uint8 entries[16];
+			for (uint32 y = 0; y < 4; ++y)
+			{
+				for (uint32 x = 0; x < 4; ++x)
+				{
+					const uint32 entry = (bc1.indices >> ((y * 4 + x) * 2)) & 0x3;
+					const uint32 weight = hasTransparent && entry == 3 ? 0 : 1;
+					entries[x * 4 + y] = (uint8)entry;
+					weights[0][x >> 1][entry] += weight;
+					weights[1][y >> 1][entry] += weight;
+				}
+			}
+
+			//per row R01, R23, G01, G23, B01, B23, A01, A23, summed to the left and right or top and bottom halves
+			__m128i rows[4];
+			DecodeBC1Indices(colorBytes, bc1.indices, rows);
+			const __m128i planarCtrl = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+			__m128i halves[4];
+			for (uint32 y = 0; y < 4; ++y)
+				halves[y] = _mm_maddubs_epi16(_mm_shuffle_epi8(rows[y], planarCtrl), _mm_set1_epi8(1));
+			const __m128i top = _mm_add_epi16(halves[0], halves[1]);
+			const __m128i bottom = _mm_add_epi16(halves[2], halves[3]);
+
+			int32 means[2][2][4];
+			GetSubblockMeans(_mm_shuffle_epi8(_mm_add_epi16(top, bottom), _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15)), means[0]);
+			GetSubblockMeans(_mm_hadd_epi16(top, bottom), means[1]);
+
+			ETC1SubblockFit fits[2][2];
+			int32 bases[2][2][3];
+			bool differential[2];
+			for (uint32 flip = 0; flip < 2; ++flip)
+			{
+				uint32 baseColor1, baseColor2;
+				differential[flip] = QuantizeETC1BaseColors(means[flip][0], means[flip][1], bases[flip][0], bases[flip][1], baseColor1, baseColor2);
+				FitETC1Subblock(baseColor1, colors, weights[flip][0], fits[flip][0]);
+				FitETC1Subblock(baseColor2, colors, weights[flip][1], fits[flip][1]);
+			}
+
+			const uint32 flip = (uint64)fits[1][0].error + fits[1][1].error < (uint64)fits[0][0].error + fits[0][1].error ? 1 : 0;
+			const uint32 subblockBits = flip ? 0xCCCC : 0xFF00;
+			uint8 selectors[16];
+			for (uint32 k = 0; k < 16; ++k)
+				selectors[k] = fits[flip][(subblockBits >> k) & 1].selectors[entries[k]];
+
+			WriteETC1Block(dest, differential[flip], flip != 0, bases[flip][0], bases[flip][1], fits[flip][0].table, fits[flip][1].table, selectors);
+		}
+
+		void TranscodeBC1ToETC1Blocks(const uint8* source, uint8* dest, uint32 blockCount)
+		{
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				EncodeETC1Block(source, dest);
+
+				source += 8;
+				dest += 8;
+			}
+		}
+	}
+}
+
+#if defined __clang__
+#pragma clang attribute pop
+#endif
+#endif
\ No newline at end of file
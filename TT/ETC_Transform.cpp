@@ -0,0 +1,249 @@
+#include <cmath>
+#include <string.h>
+#include "ETC.h"
+#include "ETCKernel.h"
+#include "Stats.h"
+#include "Math.h"
+namespace TT
+{
+	//8 bit sRGB to linear and back, rounded to nearest
+	struct SRGBTables
+	{
+		uint8 toLinear[256];
+		uint8 toSRGB[256];
+
+		SRGBTables()
+		{
+			for (uint32 i = 0; i < 256; ++i)
+			{
+				const double c = i / 255.0;
+				const double linear = c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+				const double srgb = c <= 0.0031308 ? c * 12.92 : 1.055 * pow(c, 1.0 / 2.4) - 0.055;
+				toLinear[i] = (uint8)(linear * 255.0 + 0.5);
+				toSRGB[i] = (uint8)(srgb * 255.0 + 0.5);
+			}
+		}
+	};
+
+	static inline uint32 MapColor(uint32 pixel, const uint8 table[256])
+	{
+		return table[pixel & 0xFF] | (table[(pixel >> 8) & 0xFF] << 8) | (table[(pixel >> 16) & 0xFF] << 16) | (pixel & 0xFF000000);
+	}
+
+	//color * alpha / 255 rounded exactly, red and blue in the 16 bit halves of one word
+	static inline uint32 Premultiply(uint32 pixel)
+	{
+		const uint32 alpha = pixel >> 24;
+		uint32 redBlue = (pixel & 0x00FF00FF) * alpha + 0x00800080;
+		redBlue = ((redBlue + ((redBlue >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+		uint32 green = ((pixel >> 8) & 0xFF) * alpha + 0x80;
+		green = ((green + (green >> 8)) >> 8) & 0xFF;
+		return (pixel & 0xFF000000) | redBlue | (green << 8);
+	}
+
+	template<uint32 transform>
+	static inline uint32 TransformPixel(uint32 pixel, const SRGBTables& tables)
+	{
+		if (transform & TT_TRANSFORM_SRGB_TO_LINEAR)
+			pixel = MapColor(pixel, tables.toLinear);
+		if (transform & TT_TRANSFORM_LINEAR_TO_SRGB)
+			pixel = MapColor(pixel, tables.toSRGB);
+		if (transform & TT_TRANSFORM_PREMULTIPLY)
+			pixel = Premultiply(pixel);
+		if (transform & TT_TRANSFORM_BGRA)
+			pixel = (pixel & 0xFF00FF00) | ((pixel & 0xFF) << 16) | ((pixel >> 16) & 0xFF);
+		return pixel;
+	}
+
+	//A chunk of a block row is decoded into a scratch strip that stays in L1, every pixel is transformed on its way to dest
+	//and the rows are stored in reverse for TT_TRANSFORM_FLIP_Y. dest is written once and never read back.
+	template<uint32 transform>
+	static void TranscodeTransformed(DecodeRowFunc decodeRow, uint32 blockSize, const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch)
+	{
+		static const SRGBTables tables;
+		const uint32 chunkBlocks = 32;
+		const uint32 scratchPitch = chunkBlocks * 16;
+		uint32 scratch[4 * chunkBlocks * 4];
+
+		const uint32 bw = (width + 3) / 4; //block width
+		const uint32 bh = (height + 3) / 4; //block height
+		for (uint32 by = 0; by < bh; ++by)
+		{
+			const uint32 rows = Min(4u, height - by * 4);
+			for (uint32 bx = 0; bx < bw; bx += chunkBlocks)
+			{
+				const uint32 blockCount = Min(chunkBlocks, bw - bx);
+				decodeRow(source + (by * bw + bx) * blockSize, (uint8*)scratch, scratchPitch, blockCount);
+
+				const uint32 columns = Min(blockCount * 4, width - bx * 4);
+				for (uint32 j = 0; j < rows; ++j)
+				{
+					const uint32 y = (transform & TT_TRANSFORM_FLIP_Y) ? height - 1 - (by * 4 + j) : by * 4 + j;
+					const uint32* in = scratch + j * chunkBlocks * 4;
+					uint32* out = (uint32*)(dest + y * destRowPitch) + bx * 4;
+					for (uint32 i = 0; i < columns; ++i)
+						out[i] = TransformPixel<transform>(in[i], tables);
+				}
+			}
+		}
+	}
+
+	typedef void (*TranscodeTransformedFunc)(DecodeRowFunc decodeRow, uint32 blockSize, const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch);
+
+	//one specialization per combination of TTOutputTransform bits
+	static const TranscodeTransformedFunc transcodeTransformedFuncs[32] =
+	{
+		TranscodeTransformed<0>, TranscodeTransformed<1>, TranscodeTransformed<2>, TranscodeTransformed<3>,
+		TranscodeTransformed<4>, TranscodeTransformed<5>, TranscodeTransformed<6>, TranscodeTransformed<7>,
+		TranscodeTransformed<8>, TranscodeTransformed<9>, TranscodeTransformed<10>, TranscodeTransformed<11>,
+		TranscodeTransformed<12>, TranscodeTransformed<13>, TranscodeTransformed<14>, TranscodeTransformed<15>,
+		TranscodeTransformed<16>, TranscodeTransformed<17>, TranscodeTransformed<18>, TranscodeTransformed<19>,
+		TranscodeTransformed<20>, TranscodeTransformed<21>, TranscodeTransformed<22>, TranscodeTransformed<23>,
+		TranscodeTransformed<24>, TranscodeTransformed<25>, TranscodeTransformed<26>, TranscodeTransformed<27>,
+		TranscodeTransformed<28>, TranscodeTransformed<29>, TranscodeTransformed<30>, TranscodeTransformed<31>,
+	};
+
+	//no transform takes the plain decoder straight into dest
+	static void TranscodeWithTransform(DecodeRowFunc decodeRow, uint32 blockSize, const uint8* source, uint8* dest, const uint32 width, const uint32 height, uint32 destRowPitch, const uint32 transform)
+	{
+		if (destRowPitch == 0)
+			destRowPitch = width * 4;
+
+		if ((transform & 31) == 0)
+			TranscodeBlockRows(decodeRow, blockSize, source, dest, destRowPitch, width, height, 0, (height + 3) / 4);
+		else
+			transcodeTransformedFuncs[transform & 31](decodeRow, blockSize, source, dest, width, height, destRowPitch);
+	}
+
+	//Spread the low 16 bits of v to the even bits
+	static inline uint32 SpreadBits(uint32 v)
+	{
+		v &= 0xFFFF;
+		v = (v | (v << 8)) & 0x00FF00FF;
+		v = (v | (v << 4)) & 0x0F0F0F0F;
+		v = (v | (v << 2)) & 0x33333333;
+		v = (v | (v << 1)) & 0x55555555;
+		return v;
+	}
+
+	static inline uint32 CeilLog2(uint32 v)
+	{
+		uint32 bits = 0;
+		while ((1u << bits) < v)
+			++bits;
+		return bits;
+	}
+
+	//Z-order of block (bx, by): the bits both coordinates have are interleaved, x first, the extra high bits of the longer side follow
+	static inline uint32 GetMortonIndex(uint32 bx, uint32 by, uint32 commonBits)
+	{
+		const uint32 low = (1u << commonBits) - 1;
+		return SpreadBits(bx & low) | (SpreadBits(by & low) << 1) | (((bx | by) >> commonBits) << (commonBits * 2));
+	}
+
+	//Blocks are decoded into an L1 strip as for the transforms, then every block is stored as one contiguous 64 byte tile.
+	//Tiles hold their pixels row-major, or in Z-order (two pixel pairs per row) when morton.
+	template<bool morton>
+	static void TranscodeTiled(DecodeRowFunc decodeRow, uint32 blockSize, const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+	{
+		const uint32 chunkBlocks = 32;
+		const uint32 scratchPitch = chunkBlocks * 16;
+		uint8 scratch[4 * chunkBlocks * 16];
+
+		const uint32 bw = (width + 3) / 4; //block width
+		const uint32 bh = (height + 3) / 4; //block height
+		const uint32 commonBits = Min(CeilLog2(bw), CeilLog2(bh));
+		for (uint32 by = 0; by < bh; ++by)
+		{
+			for (uint32 bx = 0; bx < bw; bx += chunkBlocks)
+			{
+				const uint32 blockCount = Min(chunkBlocks, bw - bx);
+				decodeRow(source + (by * bw + bx) * blockSize, scratch, scratchPitch, blockCount);
+
+				for (uint32 i = 0; i < blockCount; ++i)
+				{
+					const uint8* block = scratch + i * 16;
+					if (morton)
+					{
+						//row y, pixel pair p lands on pair (y & 1) | p << 1 | (y & 2) << 1 of the tile
+						uint8* tile = dest + (size_t)GetMortonIndex(bx + i, by, commonBits) * 64;
+						for (uint32 y = 0; y < 4; ++y)
+						{
+							memcpy(tile + ((y & 1) | ((y & 2) << 1)) * 8, block + y * scratchPitch, 8);
+							memcpy(tile + ((y & 1) | 2 | ((y & 2) << 1)) * 8, block + y * scratchPitch + 8, 8);
+						}
+					}
+					else
+					{
+						uint8* tile = dest + ((size_t)by * bw + bx + i) * 64;
+						for (uint32 y = 0; y < 4; ++y)
+							memcpy(tile + y * 16, block + y * scratchPitch, 16);
+					}
+				}
+			}
+		}
+	}
+
+	static void TranscodeWithLayout(DecodeRowFunc decodeRow, uint32 blockSize, const uint8* source, uint8* dest, const uint32 width, const uint32 height, const TTOutputLayout layout)
+	{
+		if (layout == TT_LAYOUT_TILED_4X4)
+			TranscodeTiled<false>(decodeRow, blockSize, source, dest, width, height);
+		else if (layout == TT_LAYOUT_MORTON)
+			TranscodeTiled<true>(decodeRow, blockSize, source, dest, width, height);
+		else
+			TranscodeImageRows(decodeRow, blockSize, source, dest, width, height);
+	}
+
+	uint32 TTGetOutputLayoutSize(const TTOutputLayout layout, const uint32 width, const uint32 height)
+	{
+		const uint32 bw = (width + 3) / 4;
+		const uint32 bh = (height + 3) / 4;
+		if (layout == TT_LAYOUT_TILED_4X4)
+			return bw * bh * 64;
+		if (layout == TT_LAYOUT_MORTON)
+		{
+			//the Z-order index runs up to the blocks of the common power of two square times the rows of squares
+			if (bw == 0 || bh == 0)
+				return 0;
+			const uint32 commonBits = Min(CeilLog2(bw), CeilLog2(bh));
+			return (GetMortonIndex(bw - 1, bh - 1, commonBits) + 1) * 64;
+		}
+		return Max(width, 4u) * 4 * height;
+	}
+
+	void TranscodeETC2_to_RGBA8_Transform(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const uint32 transform)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, (uint64)width * height * 4);
+		TranscodeWithTransform(GetKernels().decodeETC2Row, 8, source, dest, width, height, destRowPitch, transform);
+	}
+
+	void TranscodeETC2_EAC_to_RGBA8_Transform(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const uint32 transform)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, (uint64)width * height * 4);
+		TranscodeWithTransform(GetKernels().decodeETC2EACRow, 16, source, dest, width, height, destRowPitch, transform);
+	}
+
+	void TranscodeETC2_A1_to_RGBA8_Transform(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const uint32 destRowPitch, const uint32 transform)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2A1, source, width, height, (uint64)width * height * 4);
+		TranscodeWithTransform(GetKernels().decodeETC2A1Row, 8, source, dest, width, height, destRowPitch, transform);
+	}
+
+	void TranscodeETC2_to_RGBA8_Layout(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const TTOutputLayout layout)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2, source, width, height, TTGetOutputLayoutSize(layout, width, height));
+		TranscodeWithLayout(GetKernels().decodeETC2Row, 8, source, dest, width, height, layout);
+	}
+
+	void TranscodeETC2_EAC_to_RGBA8_Layout(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const TTOutputLayout layout)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2EAC, source, width, height, TTGetOutputLayoutSize(layout, width, height));
+		TranscodeWithLayout(GetKernels().decodeETC2EACRow, 16, source, dest, width, height, layout);
+	}
+
+	void TranscodeETC2_A1_to_RGBA8_Layout(const uint8* source, uint8* dest, const uint32 width, const uint32 height, const TTOutputLayout layout)
+	{
+		TT_STATS_SCOPE(StatsSourceETC2A1, source, width, height, TTGetOutputLayoutSize(layout, width, height));
+		TranscodeWithLayout(GetKernels().decodeETC2A1Row, 8, source, dest, width, height, layout);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,415 @@
+#include "KTX.h"
+#include "Math.h"
+#include <string.h>
+#if defined _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace TT
+{
+	static const uint8 ktx1Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+	static const uint8 ktx2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+	static const uint32 blockSizes[TT_FORMAT_COUNT] = { 0, 8, 8, 8, 16, 8, 8, 16, 16, 8, 8, 16 };
+
+	struct FormatCode
+	{
+		uint32 code;
+		TTFormat format;
+		uint32 isSRGB;
+	};
+
+	//glInternalFormat of KTX1
+	static const FormatCode glFormats[] =
+	{
+		{ 0x8D64, TT_FORMAT_ETC1_RGB8, 0 }, //ETC1_RGB8_OES
+		{ 0x9270, TT_FORMAT_EAC_R11, 0 }, //COMPRESSED_R11_EAC
+		{ 0x9271, TT_FORMAT_EAC_SIGNED_R11, 0 },
+		{ 0x9272, TT_FORMAT_EAC_RG11, 0 },
+		{ 0x9273, TT_FORMAT_EAC_SIGNED_RG11, 0 },
+		{ 0x9274, TT_FORMAT_ETC2_RGB8, 0 }, //COMPRESSED_RGB8_ETC2
+		{ 0x9275, TT_FORMAT_ETC2_RGB8, 1 },
+		{ 0x9276, TT_FORMAT_ETC2_RGB8A1, 0 }, //COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+		{ 0x9277, TT_FORMAT_ETC2_RGB8A1, 1 },
+		{ 0x9278, TT_FORMAT_ETC2_RGBA8_EAC, 0 }, //COMPRESSED_RGBA8_ETC2_EAC
+		{ 0x9279, TT_FORMAT_ETC2_RGBA8_EAC, 1 },
+		{ 0x83F0, TT_FORMAT_BC1_RGB, 0 }, //COMPRESSED_RGB_S3TC_DXT1_EXT
+		{ 0x83F1, TT_FORMAT_BC1_RGBA, 0 },
+		{ 0x83F3, TT_FORMAT_BC3_RGBA, 0 }, //COMPRESSED_RGBA_S3TC_DXT5_EXT
+		{ 0x8C4C, TT_FORMAT_BC1_RGB, 1 }, //COMPRESSED_SRGB_S3TC_DXT1_EXT
+		{ 0x8C4D, TT_FORMAT_BC1_RGBA, 1 },
+		{ 0x8C4F, TT_FORMAT_BC3_RGBA, 1 },
+	};
+
+	//vkFormat of KTX2
+	static const FormatCode vkFormats[] =
+	{
+		{ 131, TT_FORMAT_BC1_RGB, 0 }, //VK_FORMAT_BC1_RGB_UNORM_BLOCK
+		{ 132, TT_FORMAT_BC1_RGB, 1 },
+		{ 133, TT_FORMAT_BC1_RGBA, 0 },
+		{ 134, TT_FORMAT_BC1_RGBA, 1 },
+		{ 137, TT_FORMAT_BC3_RGBA, 0 }, //VK_FORMAT_BC3_UNORM_BLOCK
+		{ 138, TT_FORMAT_BC3_RGBA, 1 },
+		{ 147, TT_FORMAT_ETC2_RGB8, 0 }, //VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+		{ 148, TT_FORMAT_ETC2_RGB8, 1 },
+		{ 149, TT_FORMAT_ETC2_RGB8A1, 0 },
+		{ 150, TT_FORMAT_ETC2_RGB8A1, 1 },
+		{ 151, TT_FORMAT_ETC2_RGBA8_EAC, 0 },
+		{ 152, TT_FORMAT_ETC2_RGBA8_EAC, 1 },
+		{ 153, TT_FORMAT_EAC_R11, 0 }, //VK_FORMAT_EAC_R11_UNORM_BLOCK
+		{ 154, TT_FORMAT_EAC_SIGNED_R11, 0 },
+		{ 155, TT_FORMAT_EAC_RG11, 0 },
+		{ 156, TT_FORMAT_EAC_SIGNED_RG11, 0 },
+	};
+
+	static void FindFormat(const FormatCode* codes, uint32 codeCount, uint32 code, TTKTXInfo& info)
+	{
+		info.format = TT_FORMAT_UNKNOWN;
+		info.isSRGB = 0;
+		for (uint32 i = 0; i < codeCount; ++i)
+		{
+			if (codes[i].code == code)
+			{
+				info.format = codes[i].format;
+				info.isSRGB = codes[i].isSRGB;
+				return;
+			}
+		}
+	}
+
+	static uint32 ReadUint32(const uint8* data, bool swap)
+	{
+		uint32 value;
+		memcpy(&value, data, 4);
+		return swap ? (value >> 24 | (value >> 8 & 0xFF00) | (value << 8 & 0xFF0000) | value << 24) : value;
+	}
+
+	//KTX2 is always little-endian
+	static uint64 ReadUint64(const uint8* data)
+	{
+		uint64 value;
+		memcpy(&value, data, 8);
+		return value;
+	}
+
+	static inline size_t Align4(size_t size)
+	{
+		return (size + 3) & ~(size_t)3;
+	}
+
+	uint32 TTGetBlockSize(TTFormat format)
+	{
+		return (uint32)format < TT_FORMAT_COUNT ? blockSizes[format] : 0;
+	}
+
+	KTXFile::KTXFile()
+		: m_data(nullptr)
+		, m_size(0)
+		, m_mapping(nullptr)
+		, m_keyValueOffset(0)
+		, m_keyValueSize(0)
+		, m_swapKeyValueSizes(false)
+	{
+		memset(&m_info, 0, sizeof(m_info));
+	}
+
+	KTXFile::~KTXFile()
+	{
+		Close();
+	}
+
+	bool KTXFile::Open(const char* path)
+	{
+		Close();
+
+#if defined _WIN32
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER fileSize;
+		HANDLE mapping = nullptr;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (mapping == nullptr)
+			return false;
+		//the view keeps the mapping alive
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (view == nullptr)
+			return false;
+		m_size = (size_t)fileSize.QuadPart;
+#else
+		const int file = open(path, O_RDONLY);
+		if (file < 0)
+			return false;
+		struct stat fileStat;
+		void* view = MAP_FAILED;
+		if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+			view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (view == MAP_FAILED)
+			return false;
+		m_size = (size_t)fileStat.st_size;
+#endif
+
+		m_mapping = view;
+		m_data = (const uint8*)view;
+		if (!Parse())
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	bool KTXFile::OpenMemory(const uint8* data, size_t size)
+	{
+		Close();
+		m_data = data;
+		m_size = size;
+		if (!Parse())
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void KTXFile::Close()
+	{
+		Unmap();
+		m_data = nullptr;
+		m_size = 0;
+		m_keyValueOffset = 0;
+		m_keyValueSize = 0;
+		m_swapKeyValueSizes = false;
+		m_levels.clear();
+		memset(&m_info, 0, sizeof(m_info));
+	}
+
+	void KTXFile::Unmap()
+	{
+		if (m_mapping == nullptr)
+			return;
+#if defined _WIN32
+		UnmapViewOfFile(m_mapping);
+#else
+		munmap(m_mapping, m_size);
+#endif
+		m_mapping = nullptr;
+	}
+
+	bool KTXFile::Parse()
+	{
+		if (m_size >= 12 && memcmp(m_data, ktx1Identifier, 12) == 0)
+			return ParseKTX1();
+		if (m_size >= 12 && memcmp(m_data, ktx2Identifier, 12) == 0)
+			return ParseKTX2();
+		return false;
+	}
+
+	bool KTXFile::ParseKTX1()
+	{
+		if (m_size < 64)
+			return false;
+
+		//written in the writer's byte order, 0x01020304 when it differs from ours
+		const uint32 endianness = ReadUint32(m_data + 12, false);
+		if (endianness != 0x04030201 && endianness != 0x01020304)
+			return false;
+		const bool swap = endianness == 0x01020304;
+
+		uint32 header[12];
+		for (uint32 i = 0; i < 12; ++i)
+			header[i] = ReadUint32(m_data + 16 + i * 4, swap);
+		const uint32 glInternalFormat = header[3];
+		const uint32 arrayElements = header[8];
+		const uint32 faces = header[9];
+		const uint32 bytesOfKeyValueData = header[11];
+
+		m_info.version = 1;
+		m_info.glInternalFormat = glInternalFormat;
+		FindFormat(glFormats, sizeof(glFormats) / sizeof(glFormats[0]), glInternalFormat, m_info);
+		m_info.width = header[5];
+		m_info.height = header[6] ? header[6] : 1;
+		m_info.depth = header[7] ? header[7] : 1;
+		m_info.levelCount = header[10] ? header[10] : 1;
+		m_info.layerCount = arrayElements ? arrayElements : 1;
+		m_info.faceCount = faces;
+		if (m_info.width == 0 || (faces != 1 && faces != 6) || m_info.levelCount > 32)
+			return false;
+
+		m_keyValueOffset = 64;
+		m_keyValueSize = bytesOfKeyValueData;
+		m_swapKeyValueSizes = swap;
+		if (bytesOfKeyValueData > m_size - 64)
+			return false;
+
+		//each level is its imageSize followed by the images, a non-array cubemap's imageSize is one face
+		//and its faces are padded to 4 bytes
+		const bool cubePadding = faces == 6 && arrayElements == 0;
+		const size_t imageCount = (size_t)m_info.layerCount * faces;
+		size_t offset = 64 + (size_t)bytesOfKeyValueData;
+		m_levels.resize(m_info.levelCount);
+		for (uint32 i = 0; i < m_info.levelCount; ++i)
+		{
+			//an unpadded level ending less than 4 bytes before the end leaves offset past m_size
+			if (offset > m_size || m_size - offset < 4)
+				return false;
+			const size_t imageSize = ReadUint32(m_data + offset, swap);
+			offset += 4;
+
+			Level& level = m_levels[i];
+			level.offset = offset;
+			level.imageSize = cubePadding ? imageSize : imageSize / imageCount;
+			level.imageStride = cubePadding ? Align4(imageSize) : level.imageSize;
+			const size_t levelSize = cubePadding ? level.imageStride * faces : imageSize;
+			if (levelSize > m_size - offset)
+				return false;
+			offset += Align4(levelSize);
+		}
+		return true;
+	}
+
+	bool KTXFile::ParseKTX2()
+	{
+		if (m_size < 80)
+			return false;
+
+		uint32 header[9];
+		for (uint32 i = 0; i < 9; ++i)
+			header[i] = ReadUint32(m_data + 12 + i * 4, false);
+		const uint32 supercompressionScheme = header[8];
+
+		m_info.version = 2;
+		m_info.vkFormat = header[0];
+		FindFormat(vkFormats, sizeof(vkFormats) / sizeof(vkFormats[0]), header[0], m_info);
+		m_info.width = header[2];
+		m_info.height = header[3] ? header[3] : 1;
+		m_info.depth = header[4] ? header[4] : 1;
+		m_info.layerCount = header[5] ? header[5] : 1;
+		m_info.faceCount = header[6];
+		m_info.levelCount = header[7] ? header[7] : 1;
+		//supercompressed levels can't be handed out without inflating them
+		if (m_info.width == 0 || (m_info.faceCount != 1 && m_info.faceCount != 6) || m_info.levelCount > 32 || supercompressionScheme != 0)
+			return false;
+
+		m_keyValueOffset = ReadUint32(m_data + 56, false);
+		m_keyValueSize = ReadUint32(m_data + 60, false);
+		if (m_keyValueOffset > m_size || m_keyValueSize > m_size - m_keyValueOffset)
+			return false;
+
+		//level index: byteOffset, byteLength and uncompressedByteLength of every level, level 0 first
+		if ((m_size - 80) / 24 < m_info.levelCount)
+			return false;
+		const size_t imageCount = (size_t)m_info.layerCount * m_info.faceCount;
+		m_levels.resize(m_info.levelCount);
+		for (uint32 i = 0; i < m_info.levelCount; ++i)
+		{
+			const uint64 byteOffset = ReadUint64(m_data + 80 + i * 24);
+			const uint64 byteLength = ReadUint64(m_data + 80 + i * 24 + 8);
+			if (byteOffset > m_size || byteLength > m_size - byteOffset)
+				return false;
+
+			Level& level = m_levels[i];
+			level.offset = (size_t)byteOffset;
+			level.imageSize = (size_t)byteLength / imageCount;
+			level.imageStride = level.imageSize;
+		}
+		return true;
+	}
+
+	bool KTXFile::GetImage(uint32 level, uint32 layer, uint32 face, TTKTXImage& image) const
+	{
+		if (level >= m_levels.size() || layer >= m_info.layerCount || face >= m_info.faceCount)
+			return false;
+
+		image.width = Max(m_info.width >> level, 1);
+		image.height = Max(m_info.height >> level, 1);
+		image.depth = Max(m_info.depth >> level, 1);
+
+		//a level too small for its blocks is refused rather than read past
+		const uint32 blockSize = TTGetBlockSize(m_info.format);
+		const size_t blocksSize = (size_t)((image.width + 3) / 4) * ((image.height + 3) / 4) * image.depth * blockSize;
+		const Level& levelInfo = m_levels[level];
+		if (levelInfo.imageSize < blocksSize)
+			return false;
+
+		image.data = m_data + levelInfo.offset + ((size_t)layer * m_info.faceCount + face) * levelInfo.imageStride;
+		image.size = (uint32)levelInfo.imageSize;
+		return true;
+	}
+
+	const uint8* KTXFile::FindValue(const char* key, uint32* length) const
+	{
+		//keyAndValueByteSize, the key with its terminating 0, the value, padding to 4 bytes
+		const size_t keyLength = strlen(key) + 1;
+		const uint8* pair = m_data + m_keyValueOffset;
+		const uint8* end = pair + m_keyValueSize;
+		while (end - pair >= 4)
+		{
+			const size_t pairSize = ReadUint32(pair, m_swapKeyValueSizes);
+			const uint8* keyAndValue = pair + 4;
+			if (pairSize > (size_t)(end - keyAndValue))
+				break;
+			if (pairSize >= keyLength && memcmp(keyAndValue, key, keyLength) == 0)
+			{
+				if (length)
+					*length = (uint32)(pairSize - keyLength);
+				return keyAndValue + keyLength;
+			}
+			pair = keyAndValue + Align4(pairSize);
+		}
+		return nullptr;
+	}
+
+	KTXFile* TTKTXOpen(const char* path)
+	{
+		KTXFile* file = new KTXFile();
+		if (!file->Open(path))
+		{
+			delete file;
+			return nullptr;
+		}
+		return file;
+	}
+
+	KTXFile* TTKTXOpenMemory(const uint8* data, uint32 size)
+	{
+		KTXFile* file = new KTXFile();
+		if (!file->OpenMemory(data, size))
+		{
+			delete file;
+			return nullptr;
+		}
+		return file;
+	}
+
+	void TTKTXClose(KTXFile* file)
+	{
+		delete file;
+	}
+
+	void TTKTXGetInfo(const KTXFile* file, TTKTXInfo* info)
+	{
+		*info = file->GetInfo();
+	}
+
+	uint32 TTKTXGetImage(const KTXFile* file, uint32 level, uint32 layer, uint32 face, TTKTXImage* image)
+	{
+		return file->GetImage(level, layer, face, *image) ? 1 : 0;
+	}
+
+	const uint8* TTKTXFindValue(const KTXFile* file, const char* key, uint32* length)
+	{
+		return file->FindValue(key, length);
+	}
+}
\ No newline at end of file
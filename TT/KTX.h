@@ -0,0 +1,109 @@
+#pragma once
+#include <vector>
+#include "BaseType.h"
+
+namespace TT
+{
+	extern "C" {
+		//Block formats of a KTX image, sRGB variants share the format and set TTKTXInfo::isSRGB
+		enum TTFormat
+		{
+			TT_FORMAT_UNKNOWN,
+			TT_FORMAT_ETC1_RGB8,
+			TT_FORMAT_ETC2_RGB8,
+			TT_FORMAT_ETC2_RGB8A1,
+			TT_FORMAT_ETC2_RGBA8_EAC,
+			TT_FORMAT_EAC_R11,
+			TT_FORMAT_EAC_SIGNED_R11,
+			TT_FORMAT_EAC_RG11,
+			TT_FORMAT_EAC_SIGNED_RG11,
+			TT_FORMAT_BC1_RGB,
+			TT_FORMAT_BC1_RGBA,
+			TT_FORMAT_BC3_RGBA,
+			TT_FORMAT_COUNT
+		};
+
+		struct TTKTXInfo
+		{
+			uint32 version; //1 or 2
+			TTFormat format;
+			uint32 isSRGB;
+			uint32 glInternalFormat; //KTX1 only
+			uint32 vkFormat; //KTX2 only
+			uint32 width;
+			uint32 height; //1 for 1D textures
+			uint32 depth; //1 for 2D textures
+			uint32 levelCount;
+			uint32 layerCount; //1 when the texture is not an array
+			uint32 faceCount; //6 for cubemaps
+		};
+
+		//Blocks of one level, layer and face, all depth slices one after the other.
+		//data points into the file and can be passed to the transcode functions with width and height.
+		struct TTKTXImage
+		{
+			const uint8* data;
+			uint32 size;
+			uint32 width;
+			uint32 height;
+			uint32 depth;
+		};
+
+		//Bytes per 4x4 block, 0 for TT_FORMAT_UNKNOWN
+		TT_EXPORT uint32 TTGetBlockSize(TTFormat format);
+	}
+
+	//KTX 1.1 (either endianness) and KTX 2.0 (without supercompression) reader.
+	//Open maps the file, OpenMemory parses a buffer the caller keeps alive; images are never copied.
+	class KTXFile
+	{
+	public:
+		KTXFile();
+		~KTXFile();
+		KTXFile(const KTXFile&) = delete;
+		KTXFile& operator=(const KTXFile&) = delete;
+
+		bool Open(const char* path);
+		bool OpenMemory(const uint8* data, size_t size);
+		void Close();
+
+		const TTKTXInfo& GetInfo() const { return m_info; }
+
+		//false when level, layer or face is out of range
+		bool GetImage(uint32 level, uint32 layer, uint32 face, TTKTXImage& image) const;
+
+		//Value of the first key/value pair named key, nullptr when there is none
+		const uint8* FindValue(const char* key, uint32* length) const;
+
+	private:
+		struct Level
+		{
+			size_t offset;
+			size_t imageSize; //one layer and face
+			size_t imageStride;
+		};
+
+		bool Parse();
+		bool ParseKTX1();
+		bool ParseKTX2();
+		void Unmap();
+
+		const uint8* m_data;
+		size_t m_size;
+		void* m_mapping;
+		TTKTXInfo m_info;
+		size_t m_keyValueOffset;
+		size_t m_keyValueSize;
+		bool m_swapKeyValueSizes;
+		std::vector<Level> m_levels;
+	};
+
+	extern "C" {
+		TT_EXPORT KTXFile* TTKTXOpen(const char* path);
+		TT_EXPORT KTXFile* TTKTXOpenMemory(const uint8* data, uint32 size);
+		TT_EXPORT void TTKTXClose(KTXFile* file);
+		TT_EXPORT void TTKTXGetInfo(const KTXFile* file, TTKTXInfo* info);
+		TT_EXPORT uint32 TTKTXGetImage(const KTXFile* file, uint32 level, uint32 layer, uint32 face, TTKTXImage* image);
+		TT_EXPORT const uint8* TTKTXFindValue(const KTXFile* file, const char* key, uint32* length);
+	}
+}
\ No newline at end of file
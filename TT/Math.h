@@ -7,6 +7,11 @@ namespace TT
 		return a > b ? a : b;
 	}
 
+	inline uint32 Min(uint32 a, uint32 b)
+	{
+		return a < b ? a : b;
+	}
+
 	//todo test return uint32?
 	inline uint8 ClampUint8(int32 n)
 	{
@@ -0,0 +1,91 @@
+#include <stddef.h>
+#include <string.h>
+#include "Stats.h"
+#if TT_ENABLE_STATS
+#include <atomic>
+#include "ETCBlock.h"
+#endif
+
+namespace TT
+{
+#if TT_ENABLE_STATS
+	//every TTStats field as an atomic, calls on several threads add to them at once
+	static const uint32 statsFieldCount = sizeof(TTStats) / sizeof(uint64);
+	static std::atomic<uint64> globalStats[statsFieldCount];
+	static const uint32 maxCallField = offsetof(TTStats, maxCallNanoseconds) / sizeof(uint64);
+	static const uint32 lastCallField = offsetof(TTStats, lastCallNanoseconds) / sizeof(uint64);
+
+	StatsScope::StatsScope(StatsSource sourceFormat, const uint8* source, uint32 width, uint32 height, uint64 destBytes)
+	{
+		memset(&m_counts, 0, sizeof(m_counts));
+		const uint32 blockSize = sourceFormat == StatsSourceETC2EAC || sourceFormat == StatsSourceEACRG11 ? 16 : 8;
+		const uint32 blockCount = ((width + 3) / 4) * ((height + 3) / 4);
+		for (uint32 i = 0; i < blockCount; ++i, source += blockSize)
+		{
+			if (sourceFormat == StatsSourceEACR11 || sourceFormat == StatsSourceEACRG11)
+			{
+				//R11 and RG11 have no color blocks, every 8 bytes are an EAC channel block
+				for (uint32 offset = 0; offset < blockSize; offset += 8)
+				{
+					++m_counts.eacBlocks;
+					m_counts.eacZeroMultiplierBlocks += ((const EACBlock*)(source + offset))->GetMultiplier() == 0;
+				}
+				continue;
+			}
+			const ETC2Block* block = (const ETC2Block*)(sourceFormat == StatsSourceETC2EAC ? source + 8 : source);
+			++m_counts.etc2Blocks[sourceFormat == StatsSourceETC2A1 ? block->GetPunchThroughMode() : block->GetMode()];
+			if (sourceFormat == StatsSourceETC2EAC)
+			{
+				++m_counts.eacBlocks;
+				m_counts.eacZeroMultiplierBlocks += ((const EACBlock*)source)->GetMultiplier() == 0;
+			}
+		}
+		m_counts.calls = 1;
+		m_counts.bytesIn = (uint64)blockCount * blockSize;
+		m_counts.bytesOut = destBytes;
+		m_start = std::chrono::steady_clock::now();
+	}
+
+	StatsScope::~StatsScope()
+	{
+		const uint64 nanoseconds = (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+		m_counts.nanoseconds = nanoseconds;
+
+		const uint64* counts = (const uint64*)&m_counts;
+		for (uint32 i = 0; i < statsFieldCount; ++i)
+		{
+			if (i != maxCallField && i != lastCallField)
+				globalStats[i].fetch_add(counts[i], std::memory_order_relaxed);
+		}
+		globalStats[lastCallField].store(nanoseconds, std::memory_order_relaxed);
+		uint64 maxCall = globalStats[maxCallField].load(std::memory_order_relaxed);
+		while (nanoseconds > maxCall && !globalStats[maxCallField].compare_exchange_weak(maxCall, nanoseconds, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	uint32 TTGetStats(TTStats* stats)
+	{
+		uint64* fields = (uint64*)stats;
+		for (uint32 i = 0; i < statsFieldCount; ++i)
+			fields[i] = globalStats[i].load(std::memory_order_relaxed);
+		return 1;
+	}
+
+	void TTResetStats()
+	{
+		for (uint32 i = 0; i < statsFieldCount; ++i)
+			globalStats[i].store(0, std::memory_order_relaxed);
+	}
+#else
+	uint32 TTGetStats(TTStats* stats)
+	{
+		memset(stats, 0, sizeof(TTStats));
+		return 0;
+	}
+
+	void TTResetStats()
+	{
+	}
+#endif
+}
\ No newline at end of file
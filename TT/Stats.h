@@ -0,0 +1,40 @@
+#pragma once
+#include "ETC.h"
+#if TT_ENABLE_STATS
+#include <chrono>
+#endif
+
+namespace TT
+{
+	//How the source of an instrumented call is laid out
+	enum StatsSource
+	{
+		StatsSourceETC2,
+		StatsSourceETC2A1,
+		StatsSourceETC2EAC,
+		StatsSourceEACR11, //one EAC channel block per 4x4 block, signed or unsigned
+		StatsSourceEACRG11, //two EAC channel blocks per 4x4 block
+	};
+
+#if TT_ENABLE_STATS
+	//Put at the top of a whole-image transcoder: the constructor counts the source blocks by mode before the clock starts,
+	//the destructor adds the counts, the bytes and the elapsed time of the call to the global stats
+	class StatsScope
+	{
+	public:
+		StatsScope(StatsSource sourceFormat, const uint8* source, uint32 width, uint32 height, uint64 destBytes);
+		~StatsScope();
+
+	private:
+		StatsScope(const StatsScope&) = delete;
+		StatsScope& operator=(const StatsScope&) = delete;
+
+		TTStats m_counts;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	#define TT_STATS_SCOPE(sourceFormat, source, width, height, destBytes) StatsScope statsScope(sourceFormat, source, width, height, destBytes)
+#else
+	#define TT_STATS_SCOPE(sourceFormat, source, width, height, destBytes)
+#endif
+}
\ No newline at end of file
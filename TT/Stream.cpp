@@ -0,0 +1,117 @@
+#include <string.h>
+#include "Stream.h"
+#include "Math.h"
+namespace TT
+{
+	DecodeRowFunc GetDecodeRow(TTFormat format)
+	{
+		const KernelTable& kernels = GetKernels();
+		switch (format)
+		{
+		case TT_FORMAT_ETC1_RGB8:
+		case TT_FORMAT_ETC2_RGB8:
+			return kernels.decodeETC2Row;
+		case TT_FORMAT_ETC2_RGB8A1:
+			return kernels.decodeETC2A1Row;
+		case TT_FORMAT_ETC2_RGBA8_EAC:
+			return kernels.decodeETC2EACRow;
+		case TT_FORMAT_BC1_RGB:
+		case TT_FORMAT_BC1_RGBA:
+			return kernels.decodeBC1Row;
+		case TT_FORMAT_BC3_RGBA:
+			return kernels.decodeBC3Row;
+		default:
+			return nullptr;
+		}
+	}
+
+	StreamTranscoder::StreamTranscoder(TTFormat format, uint8* dest, uint32 width, uint32 height, uint32 destRowPitch)
+		: m_decodeRow(GetDecodeRow(format))
+		, m_blockSize(TTGetBlockSize(format))
+		, m_dest(dest)
+		, m_width(width)
+		, m_height(height)
+		, m_destRowPitch(destRowPitch ? destRowPitch : width * 4)
+		, m_blockHeight(m_decodeRow ? (height + 3) / 4 : 0)
+		, m_blockRowSize((size_t)((width + 3) / 4) * m_blockSize)
+		, m_blockRow(0)
+		, m_pending(m_blockRowSize)
+		, m_pendingSize(0)
+	{
+	}
+
+	bool StreamTranscoder::IsSupported(TTFormat format)
+	{
+		return GetDecodeRow(format) != nullptr;
+	}
+
+	uint32 StreamTranscoder::Append(const uint8* data, size_t size)
+	{
+		if (m_blockRowSize == 0)
+			return GetReadyRows();
+
+		//finish the block row started by earlier chunks
+		if (m_pendingSize > 0 && m_blockRow < m_blockHeight)
+		{
+			const size_t missing = m_blockRowSize - m_pendingSize;
+			const size_t copySize = size < missing ? size : missing;
+			memcpy(m_pending.data() + m_pendingSize, data, copySize);
+			m_pendingSize += copySize;
+			data += copySize;
+			size -= copySize;
+			if (m_pendingSize < m_blockRowSize)
+				return GetReadyRows();
+			DecodeBlockRows(m_pending.data(), 1);
+			m_pendingSize = 0;
+		}
+
+		const size_t wholeRows = size / m_blockRowSize;
+		const uint32 count = wholeRows < m_blockHeight - m_blockRow ? (uint32)wholeRows : m_blockHeight - m_blockRow;
+		if (count > 0)
+		{
+			DecodeBlockRows(data, count);
+			data += count * m_blockRowSize;
+			size -= count * m_blockRowSize;
+		}
+
+		if (m_blockRow < m_blockHeight && size > 0)
+		{
+			memcpy(m_pending.data(), data, size);
+			m_pendingSize = size;
+		}
+		return GetReadyRows();
+	}
+
+	uint32 StreamTranscoder::GetReadyRows() const
+	{
+		return Min(m_blockRow * 4, m_height);
+	}
+
+	void StreamTranscoder::DecodeBlockRows(const uint8* source, uint32 count)
+	{
+		TranscodeBlockRows(m_decodeRow, m_blockSize, source, m_dest + (size_t)m_blockRow * 4 * m_destRowPitch, m_destRowPitch, m_width, m_height, m_blockRow, m_blockRow + count);
+		m_blockRow += count;
+	}
+
+	StreamTranscoder* TTStreamCreate(TTFormat format, uint8* dest, uint32 width, uint32 height, uint32 destRowPitch)
+	{
+		if (!StreamTranscoder::IsSupported(format))
+			return nullptr;
+		return new StreamTranscoder(format, dest, width, height, destRowPitch);
+	}
+
+	void TTStreamDestroy(StreamTranscoder* stream)
+	{
+		delete stream;
+	}
+
+	uint32 TTStreamAppend(StreamTranscoder* stream, const uint8* data, uint32 size)
+	{
+		return stream->Append(data, size);
+	}
+
+	uint32 TTStreamGetReadyRows(const StreamTranscoder* stream)
+	{
+		return stream->GetReadyRows();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include "BaseType.h"
+#include "ETCKernel.h"
+#include "KTX.h"
+
+namespace TT
+{
+	//Row decoder to RGBA8 of ETC1_RGB8, ETC2_RGB8, ETC2_RGB8A1, ETC2_RGBA8_EAC, BC1_RGB, BC1_RGBA and BC3_RGBA, nullptr otherwise
+	DecodeRowFunc GetDecodeRow(TTFormat format);
+
+	//Decodes an image to RGBA8 while its blocks arrive. Bytes are appended in chunks of any size, every block row
+	//is decoded as soon as its last byte is in, so pixel rows become final top to bottom before the download ends.
+	//Whole block rows inside a chunk are decoded in place, only a block row split across chunks is copied.
+	class StreamTranscoder
+	{
+	public:
+		//format is ETC1_RGB8, ETC2_RGB8, ETC2_RGB8A1, ETC2_RGBA8_EAC, BC1_RGB, BC1_RGBA or BC3_RGBA, see IsSupported.
+		//dest rows are destRowPitch bytes apart, 0 means width * 4.
+		StreamTranscoder(TTFormat format, uint8* dest, uint32 width, uint32 height, uint32 destRowPitch);
+		StreamTranscoder(const StreamTranscoder&) = delete;
+		StreamTranscoder& operator=(const StreamTranscoder&) = delete;
+
+		static bool IsSupported(TTFormat format);
+
+		//Bytes past the end of the image are ignored. Returns GetReadyRows().
+		uint32 Append(const uint8* data, size_t size);
+
+		//Pixel rows [0, GetReadyRows()) of dest are final
+		uint32 GetReadyRows() const;
+		bool IsComplete() const { return m_blockRow == m_blockHeight; }
+
+	private:
+		void DecodeBlockRows(const uint8* source, uint32 count);
+
+		DecodeRowFunc m_decodeRow;
+		uint32 m_blockSize;
+		uint8* m_dest;
+		uint32 m_width;
+		uint32 m_height;
+		uint32 m_destRowPitch;
+		uint32 m_blockHeight;
+		size_t m_blockRowSize;
+		uint32 m_blockRow; //next block row to decode
+		std::vector<uint8> m_pending; //start of block row m_blockRow
+		size_t m_pendingSize;
+	};
+
+	extern "C" {
+		//nullptr when format can't be streamed to RGBA8
+		TT_EXPORT StreamTranscoder* TTStreamCreate(TTFormat format, uint8* dest, uint32 width, uint32 height, uint32 destRowPitch);
+		TT_EXPORT void TTStreamDestroy(StreamTranscoder* stream);
+		TT_EXPORT uint32 TTStreamAppend(StreamTranscoder* stream, const uint8* data, uint32 size);
+		TT_EXPORT uint32 TTStreamGetReadyRows(const StreamTranscoder* stream);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "ThreadPool.h"
+#if defined __EMSCRIPTEN_PTHREADS__
+#include <emscripten/threading.h>
+#endif
+namespace TT
+{
+	//Publish the completion of a posted task, under emscripten JS waits on the flag with Atomics.waitAsync
+	static void SetDone(uint32* done)
+	{
+		if (!done)
+			return;
+#if TT_THREADS
+		((std::atomic<uint32>*)done)->store(1, std::memory_order_release);
+#else
+		*done = 1;
+#endif
+#if defined __EMSCRIPTEN_PTHREADS__
+		emscripten_futex_wake(done, 0x7FFFFFFF);
+#endif
+	}
+
+	ThreadPool& ThreadPool::Instance()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+#if TT_THREADS
+	ThreadPool::ThreadPool()
+		: m_task(nullptr)
+		, m_taskData(nullptr)
+		, m_taskCount(0)
+		, m_nextTask(0)
+		, m_activeWorkers(0)
+		, m_busyWorkers(0)
+		, m_generation(0)
+		, m_quit(false)
+		, m_quitDispatch(false)
+	{
+		uint32 hardwareThreads = std::thread::hardware_concurrency();
+		for (uint32 i = 1; i < hardwareThreads; ++i)
+			m_workers.emplace_back(&ThreadPool::WorkerLoop, this, i - 1);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		//the dispatch thread may be inside Run, stop it while the workers are still there
+		{
+			std::lock_guard<std::mutex> lock(m_postMutex);
+			m_quitDispatch = true;
+		}
+		m_postCondition.notify_one();
+		if (m_dispatcher.joinable())
+			m_dispatcher.join();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_wakeCondition.notify_all();
+		for (auto& worker : m_workers)
+			worker.join();
+	}
+
+	uint32 ThreadPool::GetThreadCount() const
+	{
+		return (uint32)m_workers.size() + 1;
+	}
+
+	void ThreadPool::Run(TTTaskFunc task, void* taskData, uint32 taskCount, uint32 threadCount)
+	{
+		if (threadCount == 0 || threadCount > GetThreadCount())
+			threadCount = GetThreadCount();
+		if (threadCount > taskCount)
+			threadCount = taskCount;
+
+		if (threadCount <= 1 || !m_runMutex.try_lock())
+		{
+			for (uint32 i = 0; i < taskCount; ++i)
+				task(taskData, i);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_task = task;
+			m_taskData = taskData;
+			m_taskCount = taskCount;
+			m_nextTask = 0;
+			m_activeWorkers = threadCount - 1;
+			m_busyWorkers = threadCount - 1;
+			++m_generation;
+		}
+		m_wakeCondition.notify_all();
+
+		ExecuteTasks();
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_doneCondition.wait(lock, [this] { return m_busyWorkers == 0; });
+		}
+		m_runMutex.unlock();
+	}
+
+	void ThreadPool::Post(TTTaskFunc task, void* taskData, uint32* done)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_postMutex);
+			if (!m_dispatcher.joinable())
+				m_dispatcher = std::thread(&ThreadPool::DispatchLoop, this);
+			m_posted.push_back({ task, taskData, done });
+		}
+		m_postCondition.notify_one();
+	}
+
+	void ThreadPool::DispatchLoop()
+	{
+		for (;;)
+		{
+			std::unique_lock<std::mutex> lock(m_postMutex);
+			m_postCondition.wait(lock, [this] { return m_quitDispatch || !m_posted.empty(); });
+			if (m_quitDispatch)
+				return;
+			PostedTask posted = m_posted.front();
+			m_posted.pop_front();
+			lock.unlock();
+
+			posted.task(posted.taskData, 0);
+			SetDone(posted.done);
+		}
+	}
+
+	void ThreadPool::WorkerLoop(uint32 workerIndex)
+	{
+		uint64 generation = 0;
+		for (;;)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeCondition.wait(lock, [&] { return m_quit || (m_generation != generation && workerIndex < m_activeWorkers); });
+			if (m_quit)
+				return;
+			generation = m_generation;
+			lock.unlock();
+
+			ExecuteTasks();
+
+			lock.lock();
+			if (--m_busyWorkers == 0)
+				m_doneCondition.notify_one();
+		}
+	}
+
+	void ThreadPool::ExecuteTasks()
+	{
+		for (;;)
+		{
+			uint32 taskIndex = m_nextTask.fetch_add(1);
+			if (taskIndex >= m_taskCount)
+				break;
+			m_task(m_taskData, taskIndex);
+		}
+	}
+#else
+	ThreadPool::ThreadPool()
+	{
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+	}
+
+	uint32 ThreadPool::GetThreadCount() const
+	{
+		return 1;
+	}
+
+	void ThreadPool::Run(TTTaskFunc task, void* taskData, uint32 taskCount, uint32 /*threadCount*/)
+	{
+		for (uint32 i = 0; i < taskCount; ++i)
+			task(taskData, i);
+	}
+
+	void ThreadPool::Post(TTTaskFunc task, void* taskData, uint32* done)
+	{
+		task(taskData, 0);
+		SetDone(done);
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include "BaseType.h"
+
+//std::thread needs -pthread under emscripten, without it every task runs on the calling thread
+#if !defined(TT_THREADS)
+	#if defined __EMSCRIPTEN__ && !defined __EMSCRIPTEN_PTHREADS__
+		#define TT_THREADS 0
+	#else
+		#define TT_THREADS 1
+	#endif
+#endif
+
+#if TT_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace TT
+{
+	extern "C" {
+		typedef void (*TTTaskFunc)(void* taskData, uint32 taskIndex);
+
+		//Caller supplied scheduler: run task(taskData, i) for every i in [0, taskCount) and return once all of them finished
+		typedef void (*TTParallelFor)(void* userData, TTTaskFunc task, void* taskData, uint32 taskCount);
+	}
+
+	class ThreadPool
+	{
+	public:
+		static ThreadPool& Instance();
+
+		//worker threads plus the calling thread
+		uint32 GetThreadCount() const;
+
+		//Run task(taskData, i) for every i in [0, taskCount) on up to threadCount threads, the calling thread included.
+		//If another thread is already running a job the tasks run serially on the calling thread.
+		void Run(TTTaskFunc task, void* taskData, uint32 taskCount, uint32 threadCount);
+
+		//Queue task(taskData, 0) on the dispatch thread and return at once, posted tasks run one after the other in order
+		//and may call Run. done, when not null, is set to 1 once the task returned and its waiters are woken.
+		//Without threads the task runs on the calling thread before Post returns.
+		void Post(TTTaskFunc task, void* taskData, uint32* done);
+
+	private:
+		ThreadPool();
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+#if TT_THREADS
+		void WorkerLoop(uint32 workerIndex);
+		void ExecuteTasks();
+		void DispatchLoop();
+
+		std::vector<std::thread> m_workers;
+		std::mutex m_runMutex;
+		std::mutex m_mutex;
+		std::condition_variable m_wakeCondition;
+		std::condition_variable m_doneCondition;
+
+		TTTaskFunc m_task;
+		void* m_taskData;
+		uint32 m_taskCount;
+		std::atomic<uint32> m_nextTask;
+		uint32 m_activeWorkers;
+		uint32 m_busyWorkers;
+		uint64 m_generation;
+		bool m_quit;
+
+		//posted tasks, the dispatch thread is started by the first Post
+		struct PostedTask
+		{
+			TTTaskFunc task;
+			void* taskData;
+			uint32* done;
+		};
+		std::thread m_dispatcher;
+		std::mutex m_postMutex;
+		std::condition_variable m_postCondition;
+		std::deque<PostedTask> m_posted;
+		bool m_quitDispatch;
+#endif
+	};
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+//Promise wrappers of the _Async transcoders, appended to the threaded build (tt.mt.js) with --post-js.
+//Each call allocates its uint32 done flag, the promise resolves once the worker pool set it and frees the flag.
+function TTWaitDone(done)
+{
+    var flags = new Int32Array(wasmMemory.buffer);
+    var index = done >> 2;
+    if (Atomics.load(flags, index) != 0)
+        return Promise.resolve();
+
+    //woken by emscripten_futex_wake in ThreadPool.cpp, the poll timer covers a missing Atomics.waitAsync
+    //and keeps Node.js from exiting, a pending waitAsync alone doesn't hold its event loop
+    var timer;
+    var poll = new Promise(function(resolve) { timer = setTimeout(resolve, typeof Atomics.waitAsync === "function" ? 16 : 1); });
+    var wake = typeof Atomics.waitAsync === "function" ? Atomics.waitAsync(flags, index, 0).value : poll;
+    return Promise.race([wake, poll]).then(function()
+    {
+        clearTimeout(timer);
+        return TTWaitDone(done);
+    });
+}
+
+function TTRunAsync(transcode, source, dest, width, height, threadCount)
+{
+    var done = _malloc(4);
+    Atomics.store(new Int32Array(wasmMemory.buffer), done >> 2, 0);
+    transcode(source, dest, width, height, threadCount || 0, done);
+    return TTWaitDone(done).then(function() { _free(done); });
+}
+
+Module["transcodeETC2_to_RGBA8"] = function(source, dest, width, height, threadCount)
+{
+    return TTRunAsync(_TranscodeETC2_to_RGBA8_Async, source, dest, width, height, threadCount);
+};
+
+Module["transcodeETC2_EAC_to_RGBA8"] = function(source, dest, width, height, threadCount)
+{
+    return TTRunAsync(_TranscodeETC2_EAC_to_RGBA8_Async, source, dest, width, height, threadCount);
+};
\ No newline at end of file
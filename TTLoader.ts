@@ -0,0 +1,59 @@
+class TTLoader
+{
+    //i32.const 0, i8x16.splat, i8x16.popcnt: only validates where wasm-simd128 is supported
+    private static simdTestModule = new Uint8Array([0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11]);
+
+    public static supportsSIMD(): boolean
+    {
+        if(typeof WebAssembly !== "object")
+            return false;
+
+        return WebAssembly.validate(this.simdTestModule);
+    }
+
+    //load tt.simd.js when wasm-simd128 is available and tt.js otherwise, both define the global Module of TT.d.ts
+    public static load(baseUrl: string): Promise<void>
+    {
+        let file = this.supportsSIMD() ? "tt.simd.js" : "tt.js";
+
+        return new Promise<void>((resolve, reject) =>
+        {
+            (window as any).Module = {
+                locateFile: (path: string) => baseUrl + path,
+                onRuntimeInitialized: () => resolve(),
+            };
+
+            let script = document.createElement("script");
+            script.src = baseUrl + file;
+            script.onerror = () => reject(new Error("failed to load " + script.src));
+            document.head.appendChild(script);
+        });
+    }
+
+    //SharedArrayBuffer needs a cross-origin isolated page (COOP same-origin and COEP require-corp headers)
+    public static supportsThreads(): boolean
+    {
+        return typeof SharedArrayBuffer === "function" && (self as any).crossOriginIsolated === true;
+    }
+
+    //load the threaded build tt.mt.js, built with MODULARIZE as the factory TTModule, and make it the global Module.
+    //Its transcodeETC2_to_RGBA8 and transcodeETC2_EAC_to_RGBA8 decode on the worker pool without blocking this thread.
+    public static loadThreaded(baseUrl: string): Promise<void>
+    {
+        return new Promise<void>((resolve, reject) =>
+        {
+            let script = document.createElement("script");
+            script.src = baseUrl + "tt.mt.js";
+            script.onerror = () => reject(new Error("failed to load " + script.src));
+            script.onload = () =>
+            {
+                (window as any).TTModule({ locateFile: (path: string) => baseUrl + path }).then((module: any) =>
+                {
+                    (window as any).Module = module;
+                    resolve();
+                }, reject);
+            };
+            document.head.appendChild(script);
+        });
+    }
+}
\ No newline at end of file
@@ -0,0 +1,611 @@
+//Transcode benchmark: every entry point over several image sizes, synthetic inputs that keep every ETC2 block in one mode
+//or every EAC block on one modifier table, and the KTX samples when they are found.
+//Every case is warmed up, then timed over repeated runs; the median run is reported as Mblocks/s and MB/s of source and output.
+//--verify instead runs every entry point on small synthetic inputs with the scalar kernels and with every other kernel set
+//the CPU has, and exits with 1 when any output differs.
+//usage: TTBench [--quick] [--list] [--verify] [--isa scalar|sse41|simd128] [filter...]    a case runs when its name contains any filter
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "../TT/BC.h"
+#include "../TT/ETC.h"
+#include "../TT/ETCBlock.h"
+#include "../TT/KTX.h"
+using namespace TT;
+
+typedef void (*TranscodeFunc)(const uint8* source, uint8* dest, const uint32 width, const uint32 height);
+
+enum SourceFormat
+{
+	SourceETC2,
+	SourceETC2_EAC,
+	SourceEAC_R11,
+	SourceEAC_RG11,
+	SourceBC1,
+	SourceBC3,
+	SourceRGBA8, //pixel rows, 64 bytes per 4x4 block
+	SourceFormatCount,
+};
+
+static const uint32 sourceBlockSizes[SourceFormatCount] = { 8, 16, 8, 16, 8, 16, 64 };
+
+struct EntryPoint
+{
+	const char* name;
+	SourceFormat source;
+	uint32 destBlockSize; //bytes written per 4x4 block
+	TranscodeFunc transcode;
+};
+
+//the variants with extra parameters, run with their defaults
+static void TranscodeETC2_Rect(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_to_RGBA8_Rect(source, dest, width, height, width * 4, nullptr);
+}
+
+static void TranscodeETC2_EAC_Rect(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA8_Rect(source, dest, width, height, width * 4, nullptr);
+}
+
+static void TranscodeETC2_MT(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_to_RGBA8_MT(source, dest, width, height, 0);
+}
+
+static void TranscodeETC2_EAC_MT(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA8_MT(source, dest, width, height, 0);
+}
+
+//serial scheduler, measures the banding overhead of the _Tasks entry points
+static void SerialFor(void* /*userData*/, TTTaskFunc task, void* taskData, uint32 taskCount)
+{
+	for (uint32 i = 0; i < taskCount; ++i)
+		task(taskData, i);
+}
+
+static void TranscodeETC2_Tasks(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_to_RGBA8_Tasks(source, dest, width, height, SerialFor, nullptr, 8);
+}
+
+static void TranscodeETC2_EAC_Tasks(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA8_Tasks(source, dest, width, height, SerialFor, nullptr, 8);
+}
+
+static void TranscodeETC2_Batched(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_to_RGBA8_Batched(source, dest, width, height, nullptr);
+}
+
+static void TranscodeETC2_EAC_Batched(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA8_Batched(source, dest, width, height, nullptr);
+}
+
+static void TranscodeETC2_Cached(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_to_RGBA8_Cached(source, dest, width, height, nullptr);
+}
+
+static void TranscodeETC2_EAC_Cached(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA8_Cached(source, dest, width, height, nullptr);
+}
+
+//the full chain down to 1x1, kept between runs so only the first run of a size allocates
+static std::vector<uint8> mipBuffer;
+
+static uint32 GetMipDests(const uint32 width, const uint32 height, uint8** mipDests)
+{
+	uint32 count = 0;
+	size_t size = 0;
+	for (uint32 w = width, h = height; w > 1 || h > 1; ++count)
+	{
+		w = std::max(w / 2, 1u);
+		h = std::max(h / 2, 1u);
+		size += (size_t)w * h * 4;
+	}
+	if (mipBuffer.size() < size)
+		mipBuffer.resize(size);
+
+	size = 0;
+	for (uint32 level = 1; level <= count; ++level)
+	{
+		mipDests[level - 1] = mipBuffer.data() + size;
+		size += (size_t)std::max(width >> level, 1u) * std::max(height >> level, 1u) * 4;
+	}
+	return count;
+}
+
+static void TranscodeETC2_Mips(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	uint8* mipDests[32];
+	const uint32 mipCount = GetMipDests(width, height, mipDests);
+	TranscodeETC2_to_RGBA8_Mips(source, dest, width, height, mipDests, mipCount);
+}
+
+static void TranscodeETC2_EAC_Mips(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	uint8* mipDests[32];
+	const uint32 mipCount = GetMipDests(width, height, mipDests);
+	TranscodeETC2_EAC_to_RGBA8_Mips(source, dest, width, height, mipDests, mipCount);
+}
+
+static void TranscodeETC2_BGRA(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_to_RGBA8_Transform(source, dest, width, height, 0, TT_TRANSFORM_BGRA);
+}
+
+static void TranscodeETC2_EAC_Premultiply_FlipY(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA8_Transform(source, dest, width, height, 0, TT_TRANSFORM_PREMULTIPLY | TT_TRANSFORM_FLIP_Y);
+}
+
+static void TranscodeETC2_EAC_Linear_Premultiply(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA8_Transform(source, dest, width, height, 0, TT_TRANSFORM_SRGB_TO_LINEAR | TT_TRANSFORM_PREMULTIPLY);
+}
+
+static void TranscodeETC2_Tiled(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_to_RGBA8_Layout(source, dest, width, height, TT_LAYOUT_TILED_4X4);
+}
+
+static void TranscodeETC2_EAC_Morton(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA8_Layout(source, dest, width, height, TT_LAYOUT_MORTON);
+}
+
+static void TranscodeETC2_to_RGB565_Dither(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_to_RGB565(source, dest, width, height, 1);
+}
+
+static void TranscodeETC2_to_RGB565_NoDither(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_to_RGB565(source, dest, width, height, 0);
+}
+
+static void TranscodeETC2_A1_to_RGBA5551_NoDither(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_A1_to_RGBA5551(source, dest, width, height, 0);
+}
+
+static void TranscodeETC2_EAC_to_RGBA4444_Dither(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA4444(source, dest, width, height, 1);
+}
+
+static void TranscodeETC2_EAC_to_RGBA4444_NoDither(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA4444(source, dest, width, height, 0);
+}
+
+static void TranscodeETC2_EAC_to_RGBA5551_NoDither(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeETC2_EAC_to_RGBA5551(source, dest, width, height, 0);
+}
+
+static void TranscodeRGBA8_to_ETC1_Fast(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeRGBA8_to_ETC1(source, dest, width, height, 0, TT_ETC_QUALITY_FAST);
+}
+
+static void TranscodeRGBA8_to_ETC1_Normal(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeRGBA8_to_ETC1(source, dest, width, height, 0, TT_ETC_QUALITY_NORMAL);
+}
+
+static void TranscodeRGBA8_to_ETC1_High(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeRGBA8_to_ETC1(source, dest, width, height, 0, TT_ETC_QUALITY_HIGH);
+}
+
+static void TranscodeRGBA8_to_ETC2_Fast(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeRGBA8_to_ETC2(source, dest, width, height, 0, TT_ETC_QUALITY_FAST);
+}
+
+static void TranscodeRGBA8_to_ETC2_Normal(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeRGBA8_to_ETC2(source, dest, width, height, 0, TT_ETC_QUALITY_NORMAL);
+}
+
+static void TranscodeRGBA8_to_ETC2_High(const uint8* source, uint8* dest, const uint32 width, const uint32 height)
+{
+	TranscodeRGBA8_to_ETC2(source, dest, width, height, 0, TT_ETC_QUALITY_HIGH);
+}
+
+static const EntryPoint entryPoints[] =
+{
+	{ "ETC2_to_RGBA8", SourceETC2, 64, TranscodeETC2_to_RGBA8 },
+	{ "ETC2_to_RGBA8_Rect", SourceETC2, 64, TranscodeETC2_Rect },
+	{ "ETC2_to_RGBA8_MT", SourceETC2, 64, TranscodeETC2_MT },
+	{ "ETC2_to_RGBA8_Tasks", SourceETC2, 64, TranscodeETC2_Tasks },
+	{ "ETC2_to_RGBA8_Batched", SourceETC2, 64, TranscodeETC2_Batched },
+	{ "ETC2_to_RGBA8_Cached", SourceETC2, 64, TranscodeETC2_Cached },
+	{ "ETC2_to_RGBA8_Mips", SourceETC2, 64, TranscodeETC2_Mips },
+	{ "ETC2_to_BGRA8", SourceETC2, 64, TranscodeETC2_BGRA },
+	{ "ETC2_to_RGBA8_Tiled", SourceETC2, 64, TranscodeETC2_Tiled },
+	{ "ETC2_to_BC1", SourceETC2, 8, TranscodeETC2_to_BC1 },
+	{ "ETC2_to_ATC_RGB", SourceETC2, 8, TranscodeETC2_to_ATC_RGB },
+	{ "ETC2_A1_to_RGBA8", SourceETC2, 64, TranscodeETC2_A1_to_RGBA8 },
+	{ "ETC2_to_RGB565", SourceETC2, 32, TranscodeETC2_to_RGB565_NoDither },
+	{ "ETC2_to_RGB565_Dither", SourceETC2, 32, TranscodeETC2_to_RGB565_Dither },
+	{ "ETC2_A1_to_RGBA5551", SourceETC2, 32, TranscodeETC2_A1_to_RGBA5551_NoDither },
+	{ "ETC2_EAC_to_RGBA8", SourceETC2_EAC, 64, TranscodeETC2_EAC_to_RGBA8 },
+	{ "ETC2_EAC_to_RGBA8_Rect", SourceETC2_EAC, 64, TranscodeETC2_EAC_Rect },
+	{ "ETC2_EAC_to_RGBA8_MT", SourceETC2_EAC, 64, TranscodeETC2_EAC_MT },
+	{ "ETC2_EAC_to_RGBA8_Tasks", SourceETC2_EAC, 64, TranscodeETC2_EAC_Tasks },
+	{ "ETC2_EAC_to_RGBA8_Batched", SourceETC2_EAC, 64, TranscodeETC2_EAC_Batched },
+	{ "ETC2_EAC_to_RGBA8_Cached", SourceETC2_EAC, 64, TranscodeETC2_EAC_Cached },
+	{ "ETC2_EAC_to_RGBA8_Mips", SourceETC2_EAC, 64, TranscodeETC2_EAC_Mips },
+	{ "ETC2_EAC_to_RGBA8_Premultiply_FlipY", SourceETC2_EAC, 64, TranscodeETC2_EAC_Premultiply_FlipY },
+	{ "ETC2_EAC_to_RGBA8_Linear_Premultiply", SourceETC2_EAC, 64, TranscodeETC2_EAC_Linear_Premultiply },
+	{ "ETC2_EAC_to_RGBA8_Morton", SourceETC2_EAC, 64, TranscodeETC2_EAC_Morton },
+	{ "ETC2_EAC_to_RGBA4444", SourceETC2_EAC, 32, TranscodeETC2_EAC_to_RGBA4444_NoDither },
+	{ "ETC2_EAC_to_RGBA4444_Dither", SourceETC2_EAC, 32, TranscodeETC2_EAC_to_RGBA4444_Dither },
+	{ "ETC2_EAC_to_RGBA5551", SourceETC2_EAC, 32, TranscodeETC2_EAC_to_RGBA5551_NoDither },
+	{ "ETC2_EAC_to_BC3", SourceETC2_EAC, 16, TranscodeETC2_EAC_to_BC3 },
+	{ "ETC2_EAC_to_ATC_RGBA", SourceETC2_EAC, 16, TranscodeETC2_EAC_to_ATC_RGBA },
+	{ "EAC_R11_to_R16", SourceEAC_R11, 32, TranscodeEAC_R11_to_R16 },
+	{ "EAC_R11_to_R8", SourceEAC_R11, 16, TranscodeEAC_R11_to_R8 },
+	{ "EAC_SIGNED_R11_to_R16", SourceEAC_R11, 32, TranscodeEAC_SIGNED_R11_to_R16 },
+	{ "EAC_SIGNED_R11_to_R8", SourceEAC_R11, 16, TranscodeEAC_SIGNED_R11_to_R8 },
+	{ "EAC_RG11_to_RG16", SourceEAC_RG11, 64, TranscodeEAC_RG11_to_RG16 },
+	{ "EAC_RG11_to_RG8", SourceEAC_RG11, 32, TranscodeEAC_RG11_to_RG8 },
+	{ "EAC_SIGNED_RG11_to_RG16", SourceEAC_RG11, 64, TranscodeEAC_SIGNED_RG11_to_RG16 },
+	{ "EAC_SIGNED_RG11_to_RG8", SourceEAC_RG11, 32, TranscodeEAC_SIGNED_RG11_to_RG8 },
+	{ "BC1_to_RGBA8", SourceBC1, 64, TranscodeBC1_to_RGBA8 },
+	{ "BC1_to_ETC1", SourceBC1, 8, TranscodeBC1_to_ETC1 },
+	{ "BC3_to_RGB8A", SourceBC3, 64, TranscodeBC3_to_RGB8A },
+	{ "RGBA8_to_ETC1_Fast", SourceRGBA8, 8, TranscodeRGBA8_to_ETC1_Fast },
+	{ "RGBA8_to_ETC1_Normal", SourceRGBA8, 8, TranscodeRGBA8_to_ETC1_Normal },
+	{ "RGBA8_to_ETC1_High", SourceRGBA8, 8, TranscodeRGBA8_to_ETC1_High },
+	{ "RGBA8_to_ETC2_Fast", SourceRGBA8, 8, TranscodeRGBA8_to_ETC2_Fast },
+	{ "RGBA8_to_ETC2_Normal", SourceRGBA8, 8, TranscodeRGBA8_to_ETC2_Normal },
+	{ "RGBA8_to_ETC2_High", SourceRGBA8, 8, TranscodeRGBA8_to_ETC2_High },
+};
+
+static const int32 anyValue = -1;
+
+//Random ETC2 block in the given ETC2Block::Mode, drawn until GetMode agrees
+static void MakeETC2Block(std::mt19937& rng, int32 mode, uint8* block)
+{
+	for (;;)
+	{
+		for (uint32 i = 0; i < 8; ++i)
+			block[i] = (uint8)rng();
+		if (mode == anyValue || ((const ETC2Block*)block)->GetMode() == (ETC2Block::Mode)mode)
+			return;
+	}
+}
+
+//Random EAC block on the given modifier table, the multiplier is never 0
+static void MakeEACBlock(std::mt19937& rng, int32 table, uint8* block)
+{
+	for (uint32 i = 0; i < 8; ++i)
+		block[i] = (uint8)rng();
+	const uint32 multiplier = 1 + rng() % 15;
+	block[1] = (uint8)(multiplier << 4 | (table == anyValue ? block[1] & 0xF : table));
+}
+
+struct Input
+{
+	std::string name;
+	uint32 width;
+	uint32 height;
+	std::vector<uint8> blocks[SourceFormatCount]; //empty when the input doesn't provide the format
+};
+
+static uint32 GetBlockCount(uint32 width, uint32 height)
+{
+	return ((width + 3) / 4) * ((height + 3) / 4);
+}
+
+//ETC2 blocks in etc2Mode and EAC blocks on eacTable, for every source format that has such blocks
+static Input MakeSyntheticInput(const std::string& name, uint32 width, uint32 height, int32 etc2Mode, int32 eacTable, uint32 seed)
+{
+	Input input;
+	input.name = name;
+	input.width = width;
+	input.height = height;
+
+	std::mt19937 rng(seed);
+	const uint32 blockCount = GetBlockCount(width, height);
+	for (uint32 format = 0; format < SourceFormatCount; ++format)
+	{
+		const bool hasETC2 = format == SourceETC2 || format == SourceETC2_EAC;
+		const bool hasEAC = format == SourceETC2_EAC || format == SourceEAC_R11 || format == SourceEAC_RG11;
+		const bool isBC = format == SourceBC1 || format == SourceBC3 || format == SourceRGBA8;
+		if ((etc2Mode != anyValue && !hasETC2) || (eacTable != anyValue && !hasEAC))
+			continue;
+
+		std::vector<uint8>& blocks = input.blocks[format];
+		blocks.resize(blockCount * sourceBlockSizes[format]);
+		for (uint32 i = 0; i < blockCount; ++i)
+		{
+			uint8* block = blocks.data() + i * sourceBlockSizes[format];
+			if (isBC)
+			{
+				for (uint32 j = 0; j < sourceBlockSizes[format]; ++j)
+					block[j] = (uint8)rng();
+			}
+			else if (format == SourceETC2)
+				MakeETC2Block(rng, etc2Mode, block);
+			else if (format == SourceETC2_EAC)
+			{
+				MakeEACBlock(rng, eacTable, block);
+				MakeETC2Block(rng, etc2Mode, block + 8);
+			}
+			else
+			{
+				MakeEACBlock(rng, eacTable, block);
+				if (format == SourceEAC_RG11)
+					MakeEACBlock(rng, eacTable, block + 8);
+			}
+		}
+	}
+	return input;
+}
+
+//Level 0 of a KTX 1.1 or 2.0 file in any of the source formats, read straight from the mapped file
+static bool LoadKTX(const std::string& path, Input& input)
+{
+	KTXFile file;
+	TTKTXImage image;
+	if (!file.Open(path.c_str()) || !file.GetImage(0, 0, 0, image))
+		return false;
+
+	SourceFormat format;
+	switch (file.GetInfo().format)
+	{
+	case TT_FORMAT_ETC1_RGB8:
+	case TT_FORMAT_ETC2_RGB8:
+		format = SourceETC2;
+		break;
+	case TT_FORMAT_ETC2_RGBA8_EAC:
+		format = SourceETC2_EAC;
+		break;
+	case TT_FORMAT_EAC_R11:
+		format = SourceEAC_R11;
+		break;
+	case TT_FORMAT_EAC_RG11:
+		format = SourceEAC_RG11;
+		break;
+	case TT_FORMAT_BC1_RGB:
+	case TT_FORMAT_BC1_RGBA:
+		format = SourceBC1;
+		break;
+	case TT_FORMAT_BC3_RGBA:
+		format = SourceBC3;
+		break;
+	default:
+		return false;
+	}
+
+	const size_t imageSize = (size_t)GetBlockCount(image.width, image.height) * sourceBlockSizes[format];
+	input.name = path.substr(path.find_last_of("/\\") + 1);
+	input.width = image.width;
+	input.height = image.height;
+	input.blocks[format].assign(image.data, image.data + imageSize);
+
+	//the decoded ETC2 pixels feed the encoders
+	if (format == SourceETC2 || format == SourceETC2_EAC)
+	{
+		input.blocks[SourceRGBA8].resize((size_t)GetBlockCount(image.width, image.height) * sourceBlockSizes[SourceRGBA8]);
+		if (format == SourceETC2)
+			TranscodeETC2_to_RGBA8(image.data, input.blocks[SourceRGBA8].data(), image.width, image.height);
+		else
+			TranscodeETC2_EAC_to_RGBA8(image.data, input.blocks[SourceRGBA8].data(), image.width, image.height);
+	}
+	return true;
+}
+
+struct Timing
+{
+	double medianSeconds;
+	uint32 runs;
+};
+
+static double Now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//Warm up for warmUpSeconds (at least 2 runs), then time single runs until timeSeconds passed (at least minRuns)
+static Timing Measure(const EntryPoint& entry, const Input& input, uint8* dest, double warmUpSeconds, double timeSeconds, uint32 minRuns)
+{
+	const uint8* source = input.blocks[entry.source].data();
+
+	double start = Now();
+	for (uint32 i = 0; i < 2 || Now() - start < warmUpSeconds; ++i)
+		entry.transcode(source, dest, input.width, input.height);
+
+	std::vector<double> runs;
+	start = Now();
+	while (runs.size() < minRuns || Now() - start < timeSeconds)
+	{
+		const double runStart = Now();
+		entry.transcode(source, dest, input.width, input.height);
+		runs.push_back(Now() - runStart);
+	}
+
+	std::sort(runs.begin(), runs.end());
+	Timing timing;
+	timing.medianSeconds = runs[runs.size() / 2];
+	timing.runs = (uint32)runs.size();
+	return timing;
+}
+
+static bool Matches(const std::string& name, const std::vector<std::string>& filters)
+{
+	if (filters.empty())
+		return true;
+	for (const std::string& filter : filters)
+	{
+		if (name.find(filter) != std::string::npos)
+			return true;
+	}
+	return false;
+}
+
+//Output of one run: dest and the mip levels below it, the bytes past the image keep their fill value
+static std::vector<uint8> RunOnce(const EntryPoint& entry, const Input& input, size_t destSize)
+{
+	std::vector<uint8> dest(destSize, 0xCD);
+	std::fill(mipBuffer.begin(), mipBuffer.end(), 0xCD);
+	entry.transcode(input.blocks[entry.source].data(), dest.data(), input.width, input.height);
+	dest.insert(dest.end(), mipBuffer.begin(), mipBuffer.end());
+	return dest;
+}
+
+//Scalar kernels against every other kernel set on sizes that are no multiple of 4, returns the number of mismatches
+static uint32 Verify(const std::vector<Input>& inputs, const std::vector<std::string>& filters)
+{
+	static const TTKernelISA isas[] = { TT_ISA_SSE41, TT_ISA_SIMD128 };
+	static const char* isaNames[] = { "sse41", "simd128" };
+	uint32 cases = 0;
+	uint32 failures = 0;
+	for (const EntryPoint& entry : entryPoints)
+	{
+		for (const Input& input : inputs)
+		{
+			const std::string name = std::string(entry.name) + "/" + input.name + "/" + std::to_string(input.width) + "x" + std::to_string(input.height);
+			if (input.blocks[entry.source].empty() || !Matches(name, filters))
+				continue;
+
+			const size_t destSize = std::max((size_t)GetBlockCount(input.width, input.height) * 64, (size_t)TTGetOutputLayoutSize(TT_LAYOUT_MORTON, input.width, input.height));
+			TTSetKernelISA(TT_ISA_SCALAR);
+			const std::vector<uint8> reference = RunOnce(entry, input, destSize);
+			for (uint32 i = 0; i < sizeof(isas) / sizeof(isas[0]); ++i)
+			{
+				if (!TTSetKernelISA(isas[i]))
+					continue;
+				const std::vector<uint8> output = RunOnce(entry, input, destSize);
+				++cases;
+				if (output.size() != reference.size() || memcmp(output.data(), reference.data(), output.size()) != 0)
+				{
+					printf("MISMATCH %s with %s kernels\n", name.c_str(), isaNames[i]);
+					++failures;
+				}
+			}
+		}
+	}
+	TTSetKernelISA(TT_ISA_AUTO);
+	printf("%u comparisons against the scalar kernels, %u mismatches\n", cases, failures);
+	return failures;
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = false;
+	bool list = false;
+	bool verify = false;
+	std::vector<std::string> filters;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--quick") == 0)
+			quick = true;
+		else if (strcmp(argv[i], "--list") == 0)
+			list = true;
+		else if (strcmp(argv[i], "--verify") == 0)
+			verify = true;
+		else if (strcmp(argv[i], "--isa") == 0 && i + 1 < argc)
+		{
+			++i;
+			const TTKernelISA isa = strcmp(argv[i], "scalar") == 0 ? TT_ISA_SCALAR : strcmp(argv[i], "sse41") == 0 ? TT_ISA_SSE41 : strcmp(argv[i], "simd128") == 0 ? TT_ISA_SIMD128 : TT_ISA_AUTO;
+			if (!TTSetKernelISA(isa))
+			{
+				printf("kernels %s are not available\n", argv[i]);
+				return 1;
+			}
+		}
+		else
+			filters.push_back(argv[i]);
+	}
+
+	std::vector<Input> inputs;
+	static const char* modeNames[5] = { "individual", "differential", "T", "H", "planar" };
+	if (verify)
+	{
+		//partial edge blocks and rows shorter than the 4-block loops of the SIMD kernels
+		static const uint32 verifySizes[][2] = { { 13, 7 }, { 3, 3 }, { 1, 1 }, { 37, 21 } };
+		for (const auto& size : verifySizes)
+		{
+			inputs.push_back(MakeSyntheticInput("mixed", size[0], size[1], anyValue, anyValue, 1));
+			for (int32 mode = 0; mode < 5; ++mode)
+				inputs.push_back(MakeSyntheticInput(std::string("mode_") + modeNames[mode], size[0], size[1], mode, anyValue, 2 + mode));
+			for (int32 table = 0; table < 16; ++table)
+				inputs.push_back(MakeSyntheticInput("eac_table" + std::to_string(table), size[0], size[1], anyValue, table, 16 + table));
+		}
+		return Verify(inputs, filters) == 0 ? 0 : 1;
+	}
+
+	//mixed random blocks over a size sweep, the per-mode and per-table inputs at one size
+	static const uint32 sizes[][2] = { { 256, 256 }, { 1024, 1024 }, { 2048, 2048 }, { 1000, 750 } };
+	for (const auto& size : sizes)
+		inputs.push_back(MakeSyntheticInput("mixed", size[0], size[1], anyValue, anyValue, 1));
+
+	for (int32 mode = 0; mode < 5; ++mode)
+		inputs.push_back(MakeSyntheticInput(std::string("mode_") + modeNames[mode], 1024, 1024, mode, anyValue, 2 + mode));
+	for (int32 table = 0; table < 16; ++table)
+		inputs.push_back(MakeSyntheticInput("eac_table" + std::to_string(table), 1024, 1024, anyValue, table, 16 + table));
+
+#ifdef TT_SAMPLE_DIR
+	static const char* samples[] = { "test.ktx", "ground.ktx" };
+	for (const char* sample : samples)
+	{
+		Input input;
+		if (LoadKTX(std::string(TT_SAMPLE_DIR) + "/" + sample, input))
+			inputs.push_back(input);
+	}
+#endif
+
+	const double warmUpSeconds = quick ? 0.01 : 0.1;
+	const double timeSeconds = quick ? 0.05 : 0.5;
+	const uint32 minRuns = quick ? 3 : 10;
+
+	static const char* isaNames[] = { "auto", "scalar", "sse41", "simd128" };
+	printf("kernels: %s\n", isaNames[TTGetKernelISA()]);
+	printf("%-26s %-18s %11s %8s %9s %6s %10s %9s %9s\n", "entry", "input", "size", "blocks", "ms", "runs", "Mblocks/s", "in MB/s", "out MB/s");
+	std::vector<uint8> dest;
+	for (const EntryPoint& entry : entryPoints)
+	{
+		for (const Input& input : inputs)
+		{
+			if (input.blocks[entry.source].empty())
+				continue;
+
+			const std::string name = std::string(entry.name) + "/" + input.name + "/" + std::to_string(input.width) + "x" + std::to_string(input.height);
+			if (!Matches(name, filters))
+				continue;
+			if (list)
+			{
+				printf("%s\n", name.c_str());
+				continue;
+			}
+
+			//RGBA8 rows of narrow images are padded to a whole block, Morton output spans its power of two blocks
+			const uint32 blockCount = GetBlockCount(input.width, input.height);
+			dest.resize(std::max((size_t)blockCount * 64, (size_t)TTGetOutputLayoutSize(TT_LAYOUT_MORTON, input.width, input.height)));
+			const Timing timing = Measure(entry, input, dest.data(), warmUpSeconds, timeSeconds, minRuns);
+
+			const double sourceBytes = (double)blockCount * sourceBlockSizes[entry.source];
+			const double destBytes = (double)blockCount * entry.destBlockSize;
+			const std::string size = std::to_string(input.width) + "x" + std::to_string(input.height);
+			printf("%-26s %-18s %11s %8u %9.3f %6u %10.2f %9.1f %9.1f\n", entry.name, input.name.c_str(), size.c_str(), blockCount,
+				timing.medianSeconds * 1e3, timing.runs, blockCount / timing.medianSeconds * 1e-6,
+				sourceBytes / timing.medianSeconds * 1e-6, destBytes / timing.medianSeconds * 1e-6);
+			fflush(stdout);
+		}
+	}
+	return 0;
+}
\ No newline at end of file
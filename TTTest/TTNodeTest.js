@@ -0,0 +1,109 @@
+//Test of the threaded Emscripten build under Node.js: node TTTest/TTNodeTest.js tt.mt.js
+//Solid images with known pixels are decoded through the awaited Module.transcode* wrappers first. Then random ETC2 and
+//ETC2+EAC images are decoded by the blocking transcoders and by several overlapping async calls, every async output
+//has to match and the main thread has to keep running while the pool decodes.
+const path = require("path");
+const TTModule = require(path.resolve(process.argv[2] || "tt.mt.js"));
+
+const sizes = [[1, 1], [5, 3], [256, 256], [1000, 750], [2048, 2048]];
+
+function randomBlocks(Module, size)
+{
+    const ptr = Module._malloc(size);
+    const bytes = new Uint8Array(size);
+    for (let i = 0; i < size; i++)
+        bytes[i] = (Math.random() * 256) | 0;
+    Module.HEAPU8.set(bytes, ptr);
+    return ptr;
+}
+
+//Differential block of base color 16 (132 in 8 bits), table 0, all indices 0: every pixel is 132 + 2.
+//The EAC block has base 200, multiplier 1, table 0, all indices 0: alpha 200 - 3.
+const solidETC2 = [0x80, 0x80, 0x80, 0x02, 0, 0, 0, 0];
+const solidEAC = [200, 0x10, 0, 0, 0, 0, 0, 0];
+
+async function checkSolid(Module, width, height, eac)
+{
+    const block = eac ? solidEAC.concat(solidETC2) : solidETC2;
+    const blockCount = ((width + 3) >> 2) * ((height + 3) >> 2);
+    const source = Module._malloc(blockCount * block.length);
+    for (let i = 0; i < blockCount; i++)
+        Module.HEAPU8.set(block, source + i * block.length);
+    //rows are Math.max(width, 4) * 4 bytes apart like TranscodeETC2_to_RGBA8
+    const pitch = Math.max(width, 4) * 4;
+    const dest = Module._malloc(pitch * height);
+    await (eac ? Module.transcodeETC2_EAC_to_RGBA8 : Module.transcodeETC2_to_RGBA8)(source, dest, width, height, 0);
+
+    let bad = 0;
+    const expected = [134, 134, 134, eac ? 197 : 255];
+    for (let y = 0; y < height; y++)
+    {
+        for (let x = 0; x < width * 4; x++)
+            bad += Module.HEAPU8[dest + y * pitch + x] != expected[x & 3] ? 1 : 0;
+    }
+    Module._free(source);
+    Module._free(dest);
+    if (bad != 0)
+        console.log("FAIL solid " + (eac ? "ETC2_EAC" : "ETC2") + " " + width + "x" + height + ", " + bad + " wrong bytes");
+    return bad != 0 ? 1 : 0;
+}
+
+async function main()
+{
+    const Module = await TTModule();
+    let failures = 0;
+    for (const [width, height] of [[1, 1], [13, 7], [64, 64]])
+    {
+        failures += await checkSolid(Module, width, height, false);
+        failures += await checkSolid(Module, width, height, true);
+    }
+
+    let ticks = 0;
+    const ticker = setInterval(() => ticks++, 0);
+
+    const cases = [];
+    for (const [width, height] of sizes)
+    {
+        for (const eac of [false, true])
+        {
+            const sourceSize = ((width + 3) >> 2) * ((height + 3) >> 2) * (eac ? 16 : 8);
+            const destSize = ((width + 3) & ~3) * ((height + 3) & ~3) * 4;
+            const source = randomBlocks(Module, sourceSize);
+            const reference = Module._malloc(destSize);
+            const dest = Module._malloc(destSize);
+            (eac ? Module._TranscodeETC2_EAC_to_RGBA8 : Module._TranscodeETC2_to_RGBA8)(source, reference, width, height);
+            cases.push({ width, height, eac, source, reference, dest, destSize });
+        }
+    }
+
+    //all calls are in flight at once, they are decoded one after the other on the pool
+    const start = Date.now();
+    const startTicks = ticks;
+    await Promise.all(cases.map(c => (c.eac ? Module.transcodeETC2_EAC_to_RGBA8 : Module.transcodeETC2_to_RGBA8)(c.source, c.dest, c.width, c.height, 0)));
+    const elapsed = Date.now() - start;
+    clearInterval(ticker);
+
+    for (const c of cases)
+    {
+        const reference = Module.HEAPU8.subarray(c.reference, c.reference + c.destSize);
+        const dest = Module.HEAPU8.subarray(c.dest, c.dest + c.destSize);
+        if (Buffer.compare(Buffer.from(reference), Buffer.from(dest)) != 0)
+        {
+            console.log("FAIL " + (c.eac ? "ETC2_EAC" : "ETC2") + " " + c.width + "x" + c.height);
+            failures++;
+        }
+        Module._free(c.source);
+        Module._free(c.reference);
+        Module._free(c.dest);
+    }
+
+    console.log(cases.length + " async transcodes in " + elapsed + " ms, the main thread ran " + (ticks - startTicks) + " timer callbacks meanwhile");
+    console.log(failures == 0 ? "OK" : failures + " failed");
+    process.exit(failures == 0 ? 0 : 1);
+}
+
+main().catch(error =>
+{
+    console.log(error);
+    process.exit(1);
+});
\ No newline at end of file
@@ -4,10 +4,11 @@
 #include "svpng.h"
 #include "../TT/ColorBlock.h"
 #include "../TT//ETC.h"
-#include "FileReader.h"
+#include "../TT/KTX.h"
+#include "../TT/Context.h"
 using namespace TT;
 
-void saveAsPNG(const char* file, uint8* data, uint32 width, uint32 height)
+void saveAsPNG(const char* file, const uint8* data, uint32 width, uint32 height)
 {
 	FILE* fp = NULL;
 	fopen_s(&fp, file, "wb");
@@ -21,42 +22,28 @@ void saveAsPNG(const char* file, uint8* data, uint32 width, uint32 height)
 
 int main()
 {
-	FileReader reader("ground.ktx");
+	KTXFile file;
+	if (!file.Open("ground.ktx"))
+		_ASSERT(false);
 
-	uint8 KtxIdentifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+	TTKTXImage image;
+	file.GetImage(0, 0, 0, image);
+	const uint8* compressedData = image.data;
+	uint32 pixelWidth = image.width;
+	uint32 pixelHeight = image.height;
 
-	for (int i = 0; i < 12; i++)
-	{
-		if (reader.ReadUint8() != KtxIdentifier[i])
-			_ASSERT(false);
-	}
-	uint32 endianness = reader.ReadUint32();
-	uint32 glType = reader.ReadUint32();
-	uint32 glTypeSize = reader.ReadUint32();
-	uint32 glFormat = reader.ReadUint32();
-	uint32 glInternalFormat = reader.ReadUint32();
-	uint32 glBaseInternalFormat = reader.ReadUint32();
-	uint32 pixelWidth = reader.ReadUint32();
-	uint32 pixelHeight = reader.ReadUint32();
-	uint32 pixelDepth = reader.ReadUint32();
-	uint32 numberOfArrayElements = reader.ReadUint32();
-	uint32 numberOfFaces = reader.ReadUint32();
-	uint32 numberOfMipmapLevels = reader.ReadUint32();
-	uint32 bytesOfKeyValueData = reader.ReadUint32();
-
-	uint32 imageSize = reader.ReadUint32();
-	const uint8* compressedData = reader.ReadBuffer(imageSize);
-
-	//uint8* unCompressedData = new uint8[imageSize * 8];
+	//uint8* unCompressedData = new uint8[image.size * 8];
 
 	//TranscodeETC2_to_RGBA8(compressedData, unCompressedData, pixelWidth, pixelHeight);
 
-	uint8* unCompressedData = new uint8[imageSize * 4];
+	TranscodeContext context;
+	context.Reserve(TT_FORMAT_ETC2_RGBA8_EAC, pixelWidth, pixelHeight, 0);
+	const uint8* unCompressedData = nullptr;
 
 	auto start = std::chrono::steady_clock::now();
 
 	for (int i = 0; i < 100; i++)
-		TranscodeETC2_EAC_to_RGBA8(compressedData, unCompressedData, pixelWidth, pixelHeight);
+		unCompressedData = context.Transcode(TT_FORMAT_ETC2_RGBA8_EAC, compressedData, pixelWidth, pixelHeight, 0);
 
 	auto end = std::chrono::steady_clock::now();
 
@@ -0,0 +1,128 @@
+//Transcoder handle owning a source and a dest region in wasm memory, both reused from texture to texture.
+//Write the compressed bytes straight into sourceView(), transcode and read the pixels from the returned view, so a
+//texture costs no malloc, free or copy. Regions only grow, reserve the largest sizes up front to never grow the heap
+//while loading. With ALLOW_MEMORY_GROWTH any allocation in the module can move the heap, so a view only stays valid
+//until the next allocation: a call on this or another handle that takes a larger size, getStats(), or _malloc elsewhere.
+class TTTranscoder
+{
+    private sourcePtr = 0;
+    private sourceCapacity = 0;
+    private destPtr = 0;
+    private destCapacity = 0;
+
+    constructor(sourceSize: number = 0, destSize: number = 0)
+    {
+        this.reserve(sourceSize, destSize);
+    }
+
+    //bytes of the blocks of a width x height image with blockSize bytes per 4x4 block
+    public static getSourceSize(width: number, height: number, blockSize: number): number
+    {
+        return ((width + 3) >> 2) * ((height + 3) >> 2) * blockSize;
+    }
+
+    //bytes written by the transcoders, rows are Math.max(width, 4) * pixelSize bytes apart
+    public static getDestSize(width: number, height: number, pixelSize: number): number
+    {
+        return Math.max(width, 4) * pixelSize * height;
+    }
+
+    //the TTStats totals of a build with TT_ENABLE_STATS as numbers, null for other builds
+    public static getStats(): { [field: string]: number } | null
+    {
+        let fields = ["calls", "individualBlocks", "differentialBlocks", "tBlocks", "hBlocks", "planarBlocks", "eacBlocks", "eacZeroMultiplierBlocks",
+            "bytesIn", "bytesOut", "nanoseconds", "lastCallNanoseconds", "maxCallNanoseconds"];
+        let ptr = Module._malloc(fields.length * 8);
+        let valid = Module._TTGetStats(ptr) != 0;
+        let words = new Uint32Array(Module.HEAPU8.buffer, ptr, fields.length * 2);
+        let stats: { [field: string]: number } = {};
+        for (let i = 0; i < fields.length; i++)
+            stats[fields[i]] = words[i * 2] + words[i * 2 + 1] * 4294967296;
+        Module._free(ptr);
+        return valid ? stats : null;
+    }
+
+    public reserve(sourceSize: number, destSize: number): void
+    {
+        if (sourceSize > this.sourceCapacity)
+        {
+            this.sourceCapacity = Math.max(sourceSize, this.sourceCapacity * 1.5 | 0);
+            Module._free(this.sourcePtr);
+            this.sourcePtr = Module._malloc(this.sourceCapacity);
+        }
+        if (destSize > this.destCapacity)
+        {
+            this.destCapacity = Math.max(destSize, this.destCapacity * 1.5 | 0);
+            Module._free(this.destPtr);
+            this.destPtr = Module._malloc(this.destCapacity);
+        }
+    }
+
+    //the first size bytes of the source region, the previous contents are lost when the region grows
+    public sourceView(size: number): Uint8Array
+    {
+        this.reserve(size, 0);
+        return new Uint8Array(Module.HEAPU8.buffer, this.sourcePtr, size);
+    }
+
+    //the dest region as written by the last transcode
+    public destView(size: number): Uint8Array
+    {
+        return new Uint8Array(Module.HEAPU8.buffer, this.destPtr, Math.min(size, this.destCapacity));
+    }
+
+    public transcodeETC2_to_RGBA8(width: number, height: number): Uint8Array
+    {
+        let destSize = this.prepare(width, height, 8, 4);
+        Module._TranscodeETC2_to_RGBA8(this.sourcePtr, this.destPtr, width, height);
+        return this.destView(destSize);
+    }
+
+    public transcodeETC2_EAC_to_RGBA8(width: number, height: number): Uint8Array
+    {
+        let destSize = this.prepare(width, height, 16, 4);
+        Module._TranscodeETC2_EAC_to_RGBA8(this.sourcePtr, this.destPtr, width, height);
+        return this.destView(destSize);
+    }
+
+    public transcodeETC2_A1_to_RGBA8(width: number, height: number): Uint8Array
+    {
+        let destSize = this.prepare(width, height, 8, 4);
+        Module._TranscodeETC2_A1_to_RGBA8(this.sourcePtr, this.destPtr, width, height);
+        return this.destView(destSize);
+    }
+
+    public transcodeETC2_to_RGB565(width: number, height: number, dither: number = 0): Uint8Array
+    {
+        let destSize = this.prepare(width, height, 8, 2);
+        Module._TranscodeETC2_to_RGB565(this.sourcePtr, this.destPtr, width, height, dither);
+        return this.destView(destSize);
+    }
+
+    public transcodeETC2_EAC_to_RGBA4444(width: number, height: number, dither: number = 0): Uint8Array
+    {
+        let destSize = this.prepare(width, height, 16, 2);
+        Module._TranscodeETC2_EAC_to_RGBA4444(this.sourcePtr, this.destPtr, width, height, dither);
+        return this.destView(destSize);
+    }
+
+    public dispose(): void
+    {
+        Module._free(this.sourcePtr);
+        Module._free(this.destPtr);
+        this.sourcePtr = this.destPtr = 0;
+        this.sourceCapacity = this.destCapacity = 0;
+    }
+
+    //the source region survives a growing dest region, only dest is reallocated. The source bytes were written before
+    //the call, so a region too small for the image is an error rather than something to grow.
+    private prepare(width: number, height: number, blockSize: number, pixelSize: number): number
+    {
+        let sourceSize = TTTranscoder.getSourceSize(width, height, blockSize);
+        if (sourceSize > this.sourceCapacity)
+            throw new Error("source region holds " + this.sourceCapacity + " bytes, a " + width + "x" + height + " image needs " + sourceSize);
+        let destSize = TTTranscoder.getDestSize(width, height, pixelSize);
+        this.reserve(0, destSize);
+        return destSize;
+    }
+}
\ No newline at end of file